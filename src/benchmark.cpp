@@ -0,0 +1,387 @@
+
+#include "benchmark.hpp"
+#include "config.hpp"
+#include "chunk.hpp"
+#include "nature.hpp"
+#include "terrain_gen.hpp"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <string_view>
+
+namespace qwy2
+{
+
+using namespace std::literals::string_view_literals;
+
+namespace
+{
+
+/* What is measured while performing one generation step on a bunch of chunks. */
+class StepMeasure
+{
+public:
+	std::string_view step_name;
+	unsigned int chunk_count;
+	double duration_seconds;
+	std::size_t allocated_bytes;
+
+public:
+	StepMeasure(std::string_view step_name);
+};
+
+StepMeasure::StepMeasure(std::string_view step_name):
+	step_name{step_name}, chunk_count{0}, duration_seconds{0.0}, allocated_bytes{0}
+{
+	;
+}
+
+void print_step_measure(StepMeasure const& measure, unsigned int chunk_volume)
+{
+	double const chunks_per_second =
+		static_cast<double>(measure.chunk_count) / measure.duration_seconds;
+	double const nanoseconds_per_block =
+		measure.duration_seconds * 1.0e9 /
+		(static_cast<double>(measure.chunk_count) * static_cast<double>(chunk_volume));
+	std::cout << "  "
+		<< std::left << std::setw(14) << measure.step_name << std::right
+		<< std::setw(8) << measure.chunk_count
+		<< std::setw(14) << std::fixed << std::setprecision(1) << chunks_per_second
+		<< std::setw(12) << std::fixed << std::setprecision(2) << nanoseconds_per_block
+		<< std::setw(18) << measure.allocated_bytes
+		<< std::endl;
+}
+
+/* Performs the given generation step on all the chunks of the given chunk rect
+ * and measures the time taken by each call. */
+template<typename GenerationFunctionType>
+void measure_step(StepMeasure& measure, ChunkRect chunk_rect,
+	GenerationFunctionType generation_function)
+{
+	using clock = std::chrono::high_resolution_clock;
+	for (ChunkCoords chunk_coords : chunk_rect)
+	{
+		auto const time_before = clock::now();
+		measure.allocated_bytes += generation_function(chunk_coords);
+		auto const time_after = clock::now();
+		measure.duration_seconds +=
+			std::chrono::duration<double>(time_after - time_before).count();
+		measure.chunk_count++;
+	}
+}
+
+/* Number of values in a `PaddedChunkNeighborhood` with the given padding. */
+std::size_t padded_volume(ChunkGeometry chunk_geometry, int padding)
+{
+	std::size_t const padded_side = chunk_geometry.side + 2 * padding;
+	return padded_side * padded_side * padded_side;
+}
+
+/* Benchmarks the whole chunk generation pipeline with the plain terrain generator
+ * currently set in the given nature. */
+void benchmark_pipeline(Nature const& nature, ChunkGeometry chunk_geometry, unsigned int radius,
+	bool greedy_meshing, std::string_view generator_name)
+{
+	unsigned int const chunk_volume = chunk_geometry.volume();
+	ChunkGrid chunk_grid{chunk_geometry, ""sv};
+
+	/* Each step requires the previous step to be done on the 3x3x3 neighborhood of the
+	 * concerned chunk, so each step has to be done on a cube of chunks of radius one more
+	 * than the cube of chunks of the next step. */
+	ChunkCoords const center{0, 0, 0};
+	StepMeasure measure_ptg{"PTG field"sv};
+	measure_step(measure_ptg, ChunkRect{center, radius + 3},
+		[&](ChunkCoords chunk_coords){
+			chunk_grid.ptg_field.insert_or_assign(chunk_coords, generate_chunk_ptg_field(
+				chunk_coords, chunk_geometry, nature));
+			return chunk_grid.ptg_field.at(chunk_coords).allocated_bytes();
+		});
+
+	/* The steps that can read from a padded copy of their neighborhood are measured both
+	 * ways, with the copy measured apart from the step that reads it so that the cost of the
+	 * copy can be compared to the cost of the lookups it saves. */
+	StepMeasure measure_ptt{"PTT field"sv};
+	measure_step(measure_ptt, ChunkRect{center, radius + 2},
+		[&](ChunkCoords chunk_coords){
+			chunk_grid.ptt_field.insert_or_assign(chunk_coords, generate_chunk_ptt_field(
+				chunk_coords, chunk_geometry,
+				chunk_grid.get_ptg_field_neighborhood(chunk_coords), nature));
+			return chunk_grid.ptt_field.at(chunk_coords).allocated_bytes();
+		});
+	std::vector<PaddedChunkNeighborhoodPtgField> padded_ptg_table;
+	StepMeasure measure_ptt_copy{"  copy"sv};
+	measure_step(measure_ptt_copy, ChunkRect{center, radius + 2},
+		[&](ChunkCoords chunk_coords){
+			padded_ptg_table.emplace_back(chunk_grid.get_ptg_field_neighborhood(chunk_coords));
+			return padded_volume(chunk_geometry, PaddedChunkNeighborhoodPtgField::padding) *
+				sizeof(PtgFieldValue);
+		});
+	StepMeasure measure_ptt_padded{"  padded"sv};
+	auto padded_ptg_iterator = padded_ptg_table.cbegin();
+	measure_step(measure_ptt_padded, ChunkRect{center, radius + 2},
+		[&](ChunkCoords chunk_coords){
+			ChunkPttField const ptt_field = generate_chunk_ptt_field(
+				chunk_coords, chunk_geometry, *padded_ptg_iterator++, nature);
+			return ptt_field.allocated_bytes();
+		});
+	padded_ptg_table.clear();
+
+	StepMeasure measure_b{"B field"sv};
+	measure_step(measure_b, ChunkRect{center, radius + 1},
+		[&](ChunkCoords chunk_coords){
+			chunk_grid.b_field.insert_or_assign(chunk_coords, generate_chunk_b_field(
+				chunk_coords, chunk_geometry,
+				chunk_grid.get_ptt_field_neighborhood(chunk_coords), nature));
+			return chunk_grid.b_field.at(chunk_coords).allocated_bytes();
+		});
+
+	/* Saving and loading B fields, without the disk accesses (the bytes are the saved ones). */
+	ChunkSaveSignature const save_signature{chunk_geometry, generator_name, 0};
+	std::vector<std::vector<char>> saved_b_table;
+	StepMeasure measure_save{"  save"sv};
+	measure_step(measure_save, ChunkRect{center, radius + 1},
+		[&](ChunkCoords chunk_coords){
+			saved_b_table.push_back(
+				serialize_chunk_b_field(chunk_grid.b_field.at(chunk_coords), save_signature));
+			return saved_b_table.back().size();
+		});
+	StepMeasure measure_load{"  load"sv};
+	auto saved_b_iterator = saved_b_table.cbegin();
+	measure_step(measure_load, ChunkRect{center, radius + 1},
+		[&](ChunkCoords chunk_coords){
+			ChunkBField const b_field = deserialize_chunk_b_field(chunk_coords, chunk_geometry,
+				saved_b_iterator->data(), saved_b_iterator->size(), save_signature);
+			saved_b_iterator++;
+			return b_field.allocated_bytes();
+		});
+	saved_b_table.clear();
+
+	StepMeasure measure_mesh{"mesh"sv};
+	std::size_t vertex_count = 0;
+	measure_step(measure_mesh, ChunkRect{center, radius},
+		[&](ChunkCoords chunk_coords){
+			ChunkMeshData* mesh_data = generate_chunk_complete_mesh(
+				chunk_coords, chunk_geometry,
+				chunk_grid.get_b_field_neighborhood(chunk_coords), nature, greedy_meshing);
+			std::size_t const allocated_bytes =
+				mesh_data->capacity() * sizeof(ChunkMeshData::value_type);
+			vertex_count += mesh_data->size();
+			delete mesh_data;
+			return allocated_bytes;
+		});
+	std::vector<PaddedChunkNeighborhoodBField> padded_b_table;
+	StepMeasure measure_mesh_copy{"  copy"sv};
+	measure_step(measure_mesh_copy, ChunkRect{center, radius},
+		[&](ChunkCoords chunk_coords){
+			padded_b_table.emplace_back(chunk_grid.get_b_field_neighborhood(chunk_coords));
+			return padded_volume(chunk_geometry, PaddedChunkNeighborhoodBField::padding) *
+				sizeof(BFieldValue);
+		});
+	StepMeasure measure_mesh_padded{"  padded"sv};
+	std::size_t padded_vertex_count = 0;
+	auto padded_b_iterator = padded_b_table.cbegin();
+	measure_step(measure_mesh_padded, ChunkRect{center, radius},
+		[&](ChunkCoords chunk_coords){
+			ChunkMeshData* mesh_data = generate_chunk_complete_mesh(
+				chunk_coords, chunk_geometry, *padded_b_iterator++, nature, greedy_meshing);
+			std::size_t const allocated_bytes =
+				mesh_data->capacity() * sizeof(ChunkMeshData::value_type);
+			padded_vertex_count += mesh_data->size();
+			delete mesh_data;
+			return allocated_bytes;
+		});
+	padded_b_table.clear();
+	if (padded_vertex_count != vertex_count)
+	{
+		std::cout << "\x1b[31m[Benchmark] Error:\x1b[39m "
+			<< "Meshing from a padded neighborhood gave " << padded_vertex_count << " vertices "
+			<< "instead of " << vertex_count << "."
+			<< std::endl;
+	}
+
+	std::cout << "[Benchmark] Terrain generator \"" << generator_name << "\" "
+		<< "(" << vertex_count << " vertices in " << measure_mesh.chunk_count << " meshes)"
+		<< std::endl;
+	std::cout << "  "
+		<< std::left << std::setw(14) << "step" << std::right
+		<< std::setw(8) << "chunks"
+		<< std::setw(14) << "chunks/s"
+		<< std::setw(12) << "ns/block"
+		<< std::setw(18) << "allocated bytes"
+		<< std::endl;
+	print_step_measure(measure_ptg, chunk_volume);
+	print_step_measure(measure_ptt, chunk_volume);
+	print_step_measure(measure_ptt_copy, chunk_volume);
+	print_step_measure(measure_ptt_padded, chunk_volume);
+	print_step_measure(measure_b, chunk_volume);
+	print_step_measure(measure_save, chunk_volume);
+	print_step_measure(measure_load, chunk_volume);
+	print_step_measure(measure_mesh, chunk_volume);
+	print_step_measure(measure_mesh_copy, chunk_volume);
+	print_step_measure(measure_mesh_padded, chunk_volume);
+}
+
+/* Measures the operations done on the chunk grid (rather than on the chunks) with both
+ * the hash table only and the ring buffer backends (see `ChunkComponentGrid`), on a cube of
+ * chunks of the given radius that gets scrolled along as if the player was moving. */
+void benchmark_chunk_grid_backend(ChunkGeometry chunk_geometry, unsigned int radius,
+	bool ring_buffer)
+{
+	using clock = std::chrono::high_resolution_clock;
+	ChunkGrid chunk_grid{chunk_geometry, ""sv};
+	if (ring_buffer)
+	{
+		/* The side of the cube plus one for the scrolling to insert before it erases. */
+		chunk_grid.use_ring_buffer(2 * radius);
+	}
+	/* Homogeneous fields, so that only the grid is measured (and not the allocations). */
+	auto const field_at = [chunk_geometry](ChunkCoords chunk_coords){
+		return ChunkBField::homogeneous(chunk_coords, chunk_geometry, Block{0});
+	};
+	auto const nanoseconds_per_operation = [](
+		clock::time_point time_before, clock::time_point time_after,
+		std::size_t operation_count
+	){
+		return std::chrono::duration<double, std::nano>(time_after - time_before).count() /
+			static_cast<double>(operation_count);
+	};
+	ChunkCoords const center{0, 0, 0};
+	ChunkRect const chunk_rect{center, radius};
+
+	auto const time_insert_before = clock::now();
+	for (ChunkCoords chunk_coords : chunk_rect)
+	{
+		chunk_grid.b_field.insert(std::make_pair(chunk_coords, field_at(chunk_coords)));
+	}
+	auto const time_insert_after = clock::now();
+
+	std::size_t found_count = 0;
+	auto const time_find_before = clock::now();
+	for (ChunkCoords chunk_coords : ChunkRect{center, radius + 1})
+	{
+		found_count += chunk_grid.has_b_field(chunk_coords) ? 1 : 0;
+	}
+	auto const time_find_after = clock::now();
+
+	ChunkRect const neighborhood_chunk_rect{center, radius - 1};
+	std::size_t homogeneous_count = 0;
+	auto const time_neighborhood_before = clock::now();
+	for (ChunkCoords chunk_coords : neighborhood_chunk_rect)
+	{
+		homogeneous_count +=
+			chunk_grid.get_b_field_neighborhood(chunk_coords).homogeneous_value().has_value();
+	}
+	auto const time_neighborhood_after = clock::now();
+
+	int coords_sum = 0;
+	auto const time_iterate_before = clock::now();
+	for (auto const& [chunk_coords, b_field] : chunk_grid.b_field)
+	{
+		coords_sum += chunk_coords.x;
+	}
+	auto const time_iterate_after = clock::now();
+
+	/* Move the cube along the x axis by its own length, one slice of chunks at a time
+	 * (the new slice gets inserted before the old one gets erased). */
+	int const side = chunk_rect.coords_max.x - chunk_rect.coords_min.x + 1;
+	ChunkCoords const coords_min = chunk_rect.coords_min;
+	ChunkCoords const coords_max = chunk_rect.coords_max;
+	auto const time_scroll_before = clock::now();
+	for (int i = 0; i < side; i++)
+	{
+		int const new_x = coords_max.x + 1 + i;
+		for (ChunkCoords chunk_coords : ChunkRect{
+			ChunkCoords{new_x, coords_min.y, coords_min.z},
+			ChunkCoords{new_x, coords_max.y, coords_max.z}})
+		{
+			chunk_grid.b_field.insert(std::make_pair(chunk_coords, field_at(chunk_coords)));
+		}
+		int const old_x = coords_min.x + i;
+		for (ChunkCoords chunk_coords : ChunkRect{
+			ChunkCoords{old_x, coords_min.y, coords_min.z},
+			ChunkCoords{old_x, coords_max.y, coords_max.z}})
+		{
+			chunk_grid.b_field.erase(chunk_coords);
+		}
+	}
+	auto const time_scroll_after = clock::now();
+
+	if (found_count != chunk_rect.volume() ||
+		homogeneous_count != neighborhood_chunk_rect.volume() ||
+		chunk_grid.b_field.size() != chunk_rect.volume())
+	{
+		std::cout << "\x1b[31m[Benchmark] Error:\x1b[39m "
+			<< "The chunk grid lost track of some chunks "
+			<< "(coords sum " << coords_sum << ")."
+			<< std::endl;
+	}
+
+	std::cout << "  "
+		<< std::setw(6) << radius
+		<< std::setw(8) << (ring_buffer ? "ring" : "hash")
+		<< std::fixed << std::setprecision(1)
+		<< std::setw(10) << nanoseconds_per_operation(
+			time_insert_before, time_insert_after, chunk_rect.volume())
+		<< std::setw(10) << nanoseconds_per_operation(
+			time_find_before, time_find_after, ChunkRect{center, radius + 1}.volume())
+		<< std::setw(14) << nanoseconds_per_operation(
+			time_neighborhood_before, time_neighborhood_after, neighborhood_chunk_rect.volume())
+		<< std::setw(10) << nanoseconds_per_operation(
+			time_iterate_before, time_iterate_after, chunk_rect.volume())
+		<< std::setw(10) << nanoseconds_per_operation(
+			time_scroll_before, time_scroll_after, 2 * chunk_rect.volume())
+		<< std::endl;
+}
+
+} /* Anonymous namespace. */
+
+ErrorCode run_chunk_generation_benchmark(Config const& config)
+{
+	ChunkGeometry const chunk_geometry{config.get<int>("chunk_side"sv)};
+	Nature* nature = generate_nature(config, false);
+
+	std::vector<std::string_view> generator_names;
+	if (config.get<bool>("benchmark_all_terrain_generators"sv))
+	{
+		generator_names = g_plain_terrain_generator_names;
+	}
+	else
+	{
+		generator_names.push_back(config.get<std::string_view>("terrain_generator"sv));
+	}
+
+	unsigned int const radius = config.get<int>("benchmark_radius"sv);
+	bool const greedy_meshing = config.get<bool>("greedy_meshing"sv);
+	std::cout << "[Benchmark] "
+		<< "Chunk side is " << chunk_geometry.side << ", "
+		<< "meshed cube of chunks has a radius of " << radius << " chunks, "
+		<< "greedy meshing is " << (greedy_meshing ? "enabled" : "disabled") << "."
+		<< std::endl;
+	for (std::string_view generator_name : generator_names)
+	{
+		nature->world_generator.plain_terrain_generator =
+			plain_terrain_generator_from_name(generator_name);
+		benchmark_pipeline(*nature, chunk_geometry, radius, greedy_meshing, generator_name);
+	}
+
+	std::cout << "[Benchmark] Chunk grid backends (ns per chunk)" << std::endl;
+	std::cout << "  "
+		<< std::setw(6) << "radius"
+		<< std::setw(8) << "backend"
+		<< std::setw(10) << "insert"
+		<< std::setw(10) << "find"
+		<< std::setw(14) << "neighborhood"
+		<< std::setw(10) << "iterate"
+		<< std::setw(10) << "scroll"
+		<< std::endl;
+	for (unsigned int grid_radius : {4, 8, 16})
+	{
+		benchmark_chunk_grid_backend(chunk_geometry, grid_radius, false);
+		benchmark_chunk_grid_backend(chunk_geometry, grid_radius, true);
+	}
+
+	return ErrorCode::OK;
+}
+
+} /* qwy2 */
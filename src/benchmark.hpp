@@ -0,0 +1,21 @@
+
+#ifndef QWY2_HEADER_BENCHMARK_
+#define QWY2_HEADER_BENCHMARK_
+
+#include "utils.hpp"
+
+namespace qwy2
+{
+
+class Config;
+
+/* Runs the chunk generation pipeline (PTG field, PTT field, B field and mesh generation)
+ * on a cube of chunks without any window nor OpenGL context, and prints the measured
+ * performance of each generation step (for each requested plain terrain generator).
+ * Everything happens on the calling thread so that the measures are the cost of each step
+ * as it would be paid by a generating thread. */
+ErrorCode run_chunk_generation_benchmark(Config const& config);
+
+} /* qwy2 */
+
+#endif /* QWY2_HEADER_BENCHMARK_ */
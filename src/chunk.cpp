@@ -5,57 +5,84 @@
 #include "threadpool.hpp"
 #include "utils.hpp"
 #include "structure.hpp"
-#include "gameloop.hpp"
 #include "entity.hpp"
+#include "field_pool.hpp"
 #include <cassert>
 #include <iostream>
 #include <iterator>
 #include <algorithm>
+#include <functional>
+#include <cmath>
 #include <sstream>
+#include <cstring>
+#include <atomic>
 
 namespace qwy2
 {
 
 /* TODO: Reduce code duplication accross this file. */
 
-BlockCoords chunk_center_coords(ChunkCoords chunk_coords)
+ChunkGeometry::ChunkGeometry():
+	side{0}
+{
+	;
+}
+
+ChunkGeometry::ChunkGeometry(int side):
+	side{side}
+{
+	;
+}
+
+unsigned int ChunkGeometry::volume() const
+{
+	return this->side * this->side * this->side;
+}
+
+BlockCoords ChunkGeometry::center_coords(ChunkCoords chunk_coords) const
 {
 	return BlockCoords{
-		chunk_coords.x * static_cast<int>(g_game->chunk_side),
-		chunk_coords.y * static_cast<int>(g_game->chunk_side),
-		chunk_coords.z * static_cast<int>(g_game->chunk_side)};
+		chunk_coords.x * this->side,
+		chunk_coords.y * this->side,
+		chunk_coords.z * this->side};
+}
+
+BlockCoords ChunkGeometry::most_negativeward_block_coords(ChunkCoords chunk_coords) const
+{
+	return this->center_coords(chunk_coords) - BlockCoords{
+		this->side / 2,
+		this->side / 2,
+		this->side / 2};
 }
 
-BlockCoords chunk_most_negativeward_block_coords(ChunkCoords chunk_coords)
+BlockCoords ChunkGeometry::most_positiveward_block_coords(ChunkCoords chunk_coords) const
 {
-	return chunk_center_coords(chunk_coords) - BlockCoords{
-		static_cast<int>(g_game->chunk_side) / 2,
-		static_cast<int>(g_game->chunk_side) / 2,
-		static_cast<int>(g_game->chunk_side) / 2};
+	return this->center_coords(chunk_coords) + BlockCoords{
+		this->side / 2,
+		this->side / 2,
+		this->side / 2};
 }
 
-BlockCoords chunk_most_positiveward_block_coords(ChunkCoords chunk_coords)
+glm::vec3 ChunkGeometry::most_negativeward_corner_coords(ChunkCoords chunk_coords) const
 {
-	return chunk_center_coords(chunk_coords) + BlockCoords{
-		static_cast<int>(g_game->chunk_side) / 2,
-		static_cast<int>(g_game->chunk_side) / 2,
-		static_cast<int>(g_game->chunk_side) / 2};
+	return static_cast<glm::vec3>(this->most_negativeward_block_coords(chunk_coords)) -
+		glm::vec3{0.5f, 0.5f, 0.5f};
 }
 
-BlockRect chunk_block_rect(ChunkCoords chunk_coords)
+BlockRect ChunkGeometry::block_rect(ChunkCoords chunk_coords) const
 {
-	BlockCoords const center_coords = chunk_center_coords(chunk_coords);
-	int const margin = g_game->chunk_side / 2;
+	BlockCoords const center_coords = this->center_coords(chunk_coords);
+	int const margin = this->side / 2;
 	return BlockRect{
 		BlockCoords{center_coords.x - margin, center_coords.y - margin, center_coords.z - margin},
 		BlockCoords{center_coords.x + margin, center_coords.y + margin, center_coords.z + margin}};
 }
 
-BlockRect chunk_rect_block_rect(ChunkRect chunk_rect)
+BlockRect ChunkGeometry::chunk_rect_block_rect(ChunkRect chunk_rect) const
 {
-	BlockCoords const center_coords_min = chunk_center_coords(chunk_rect.coords_min);
-	BlockCoords const center_coords_max = chunk_center_coords(chunk_rect.coords_max);
-	int const margin = g_game->chunk_side / 2;
+	BlockCoords const center_coords_min = this->center_coords(chunk_rect.coords_min);
+	BlockCoords const center_coords_max = this->center_coords(chunk_rect.coords_max);
+	int const margin = this->side / 2;
 	return BlockRect{
 		BlockCoords{
 			center_coords_min.x - margin,
@@ -67,29 +94,36 @@ BlockRect chunk_rect_block_rect(ChunkRect chunk_rect)
 			center_coords_max.z + margin}};
 }
 
-ChunkCoords containing_chunk_coords(BlockCoords coords)
+ChunkCoords ChunkGeometry::containing_chunk_coords(BlockCoords coords) const
 {
-	int const chunk_side_int = static_cast<int>(g_game->chunk_side);
 	return ChunkCoords{
-		(coords.x + (coords.x < 0 ? -1 : 1) * chunk_side_int / 2) / chunk_side_int,
-		(coords.y + (coords.y < 0 ? -1 : 1) * chunk_side_int / 2) / chunk_side_int,
-		(coords.z + (coords.z < 0 ? -1 : 1) * chunk_side_int / 2) / chunk_side_int};
+		(coords.x + (coords.x < 0 ? -1 : 1) * this->side / 2) / this->side,
+		(coords.y + (coords.y < 0 ? -1 : 1) * this->side / 2) / this->side,
+		(coords.z + (coords.z < 0 ? -1 : 1) * this->side / 2) / this->side};
 }
 
-ChunkCoords containing_chunk_coords(glm::vec3 coords)
+ChunkCoords ChunkGeometry::containing_chunk_coords(glm::vec3 coords) const
 {
-	return containing_chunk_coords(
+	return this->containing_chunk_coords(
 		BlockCoords{
 			static_cast<int>(std::round(coords.x)),
 			static_cast<int>(std::round(coords.y)),
 			static_cast<int>(std::round(coords.z))});
 }
 
-ChunkRect containing_chunk_rect(BlockRect block_rect)
+ChunkRect ChunkGeometry::containing_chunk_rect(BlockRect block_rect) const
 {
 	return ChunkRect{
-		containing_chunk_coords(block_rect.coords_min),
-		containing_chunk_coords(block_rect.coords_max)};
+		this->containing_chunk_coords(block_rect.coords_min),
+		this->containing_chunk_coords(block_rect.coords_max)};
+}
+
+unsigned int ChunkGeometry::local_index(BlockCoords local_coords) const
+{
+	return
+		local_coords.x +
+		this->side * local_coords.y +
+		this->side * this->side * local_coords.z;
 }
 
 AlignedBox block_rect_box(BlockRect block_rect)
@@ -101,95 +135,390 @@ AlignedBox block_rect_box(BlockRect block_rect)
 	return AlignedBox{(coords_min + coords_max) / 2.0f, coords_max - coords_min};
 }
 
-inline static unsigned int chunk_volume()
+template<typename FieldValueType>
+FieldValueType ChunkField<FieldValueType>::PackedValues::get(unsigned int index) const
 {
-	return g_game->chunk_side * g_game->chunk_side * g_game->chunk_side;
+	unsigned int const bit_index = index * this->bits_per_value;
+	std::uint64_t const word = this->words[bit_index / 64];
+	std::uint64_t const mask = (std::uint64_t{1} << this->bits_per_value) - 1;
+	return this->palette[(word >> (bit_index % 64)) & mask];
 }
 
 template<typename FieldValueType>
 ChunkField<FieldValueType>::ChunkField():
 	chunk_coords{0, 0, 0},
-	data{nullptr}
+	geometry{},
+	data{nullptr},
+	value_if_homogeneous{},
+	packed_values{}
 {
 	;
 }
 
 template<typename FieldValueType>
-ChunkField<FieldValueType>::ChunkField(ChunkCoords chunk_coords):
+ChunkField<FieldValueType>::ChunkField(ChunkCoords chunk_coords, ChunkGeometry geometry):
 	chunk_coords{chunk_coords},
-	data{new FieldValueType[chunk_volume()]}
+	geometry{geometry},
+	data{allocate_data(geometry.volume())},
+	value_if_homogeneous{},
+	packed_values{}
 {
 	;
 }
 
 template<typename FieldValueType>
-ChunkField<FieldValueType>::ChunkField(ChunkCoords chunk_coords, ValueType* data):
-	chunk_coords{chunk_coords},
-	data{data}
+std::shared_ptr<FieldValueType[]> ChunkField<FieldValueType>::allocate_data(unsigned int volume)
 {
-	;
+	return std::shared_ptr<FieldValueType[]>{
+		FieldBufferPool<FieldValueType>::global().acquire(volume),
+		[volume](FieldValueType* data){
+			FieldBufferPool<FieldValueType>::global().release(data, volume);
+		}};
 }
 
 template<typename FieldValueType>
-ChunkField<FieldValueType>::~ChunkField()
+ChunkField<FieldValueType> ChunkField<FieldValueType>::homogeneous(
+	ChunkCoords chunk_coords, ChunkGeometry geometry, ValueType value)
 {
-	//delete[] this->data;
+	ChunkField field{};
+	field.chunk_coords = chunk_coords;
+	field.geometry = geometry;
+	field.value_if_homogeneous = value;
+	return field;
 }
 
 template<typename FieldValueType>
 FieldValueType& ChunkField<FieldValueType>::operator[](BlockCoords coords)
 {
+	if (this->data == nullptr)
+	{
+		this->unpack();
+	}
+	else
+	{
+		this->make_data_unshared();
+	}
 	BlockCoords const local_coords =
-		coords - chunk_most_negativeward_block_coords(this->chunk_coords);
-	return this->data[
-		local_coords.x +
-		g_game->chunk_side * local_coords.y + 
-		g_game->chunk_side * g_game->chunk_side * local_coords.z];
+		coords - this->geometry.most_negativeward_block_coords(this->chunk_coords);
+	return this->data[this->geometry.local_index(local_coords)];
 }
 
 template<typename FieldValueType>
-FieldValueType const& ChunkField<FieldValueType>::operator[](BlockCoords coords) const
+FieldValueType ChunkField<FieldValueType>::operator[](BlockCoords coords) const
 {
 	BlockCoords const local_coords =
-		coords - chunk_most_negativeward_block_coords(this->chunk_coords);
-	return this->data[
-		local_coords.x +
-		g_game->chunk_side * local_coords.y + 
-		g_game->chunk_side * g_game->chunk_side * local_coords.z];
+		coords - this->geometry.most_negativeward_block_coords(this->chunk_coords);
+	return this->get(this->geometry.local_index(local_coords));
+}
+
+template<typename FieldValueType>
+FieldValueType ChunkField<FieldValueType>::get(unsigned int local_index) const
+{
+	if (this->data != nullptr)
+	{
+		return this->data[local_index];
+	}
+	else if (this->packed_values != nullptr)
+	{
+		return this->packed_values->get(local_index);
+	}
+	else
+	{
+		return this->value_if_homogeneous;
+	}
+}
+
+namespace
+{
+
+/* Returns the smallest number of bits per value (that divides 64) that can index
+ * a palette of the given size, or 0 if there is none. */
+unsigned int packed_bits_per_value(std::size_t palette_size)
+{
+	for (unsigned int bits_per_value : {1, 2, 4, 8})
+	{
+		if (palette_size <= (std::size_t{1} << bits_per_value))
+		{
+			return bits_per_value;
+		}
+	}
+	return 0;
+}
+
+} /* Anonymous namespace. */
+
+template<typename FieldValueType>
+void ChunkField<FieldValueType>::set(BlockCoords coords, ValueType value)
+{
+	BlockCoords const local_coords =
+		coords - this->geometry.most_negativeward_block_coords(this->chunk_coords);
+	unsigned int const local_index = this->geometry.local_index(local_coords);
+	if (this->data != nullptr)
+	{
+		this->make_data_unshared();
+		this->data[local_index] = value;
+		return;
+	}
+	else if (this->get(local_index) == value)
+	{
+		return;
+	}
+
+	/* The packed values are copied (and repacked with more bits per value if needed)
+	 * instead of being modified, see `packed_values`. */
+	unsigned int const volume = this->geometry.volume();
+	std::shared_ptr<PackedValues> new_packed_values = std::make_shared<PackedValues>();
+	if (this->packed_values == nullptr)
+	{
+		new_packed_values->palette.push_back(this->value_if_homogeneous);
+	}
+	else
+	{
+		new_packed_values->palette = this->packed_values->palette;
+	}
+	unsigned int palette_index = std::find(new_packed_values->palette.begin(),
+		new_packed_values->palette.end(), value) - new_packed_values->palette.begin();
+	if (palette_index == new_packed_values->palette.size())
+	{
+		new_packed_values->palette.push_back(value);
+	}
+	unsigned int const bits_per_value =
+		packed_bits_per_value(new_packed_values->palette.size());
+	if (bits_per_value == 0)
+	{
+		/* Too many different values to be packed. */
+		this->unpack();
+		this->data[local_index] = value;
+		return;
+	}
+	new_packed_values->bits_per_value = bits_per_value;
+
+	if (this->packed_values != nullptr && this->packed_values->bits_per_value == bits_per_value)
+	{
+		new_packed_values->words = this->packed_values->words;
+	}
+	else
+	{
+		/* Repacking, the palette indices of the values do not change. */
+		unsigned int const values_per_word = 64 / bits_per_value;
+		new_packed_values->words.resize((volume + values_per_word - 1) / values_per_word, 0);
+		if (this->packed_values != nullptr)
+		{
+			PackedValues const& old_packed_values = *this->packed_values;
+			unsigned int const old_bits_per_value = old_packed_values.bits_per_value;
+			std::uint64_t const old_mask = (std::uint64_t{1} << old_bits_per_value) - 1;
+			for (unsigned int i = 0; i < volume; i++)
+			{
+				unsigned int const old_bit_index = i * old_bits_per_value;
+				std::uint64_t const index =
+					(old_packed_values.words[old_bit_index / 64] >> (old_bit_index % 64)) &
+					old_mask;
+				unsigned int const bit_index = i * bits_per_value;
+				new_packed_values->words[bit_index / 64] |= index << (bit_index % 64);
+			}
+		}
+	}
+
+	unsigned int const bit_index = local_index * bits_per_value;
+	std::uint64_t const mask = (std::uint64_t{1} << bits_per_value) - 1;
+	std::uint64_t& word = new_packed_values->words[bit_index / 64];
+	word &= ~(mask << (bit_index % 64));
+	word |= std::uint64_t{palette_index} << (bit_index % 64);
+	this->packed_values = std::move(new_packed_values);
 }
 
 template<typename FieldValueType>
 FieldValueType* ChunkField<FieldValueType>::raw_data()
 {
-	return this->data;
+	if (this->data != nullptr)
+	{
+		this->make_data_unshared();
+	}
+	return this->data.get();
+}
+
+template<typename FieldValueType>
+FieldValueType const* ChunkField<FieldValueType>::raw_data() const
+{
+	return this->data.get();
+}
+
+template<typename FieldValueType>
+bool ChunkField<FieldValueType>::is_homogeneous() const
+{
+	return this->data == nullptr && this->packed_values == nullptr;
+}
+
+template<typename FieldValueType>
+bool ChunkField<FieldValueType>::is_packed() const
+{
+	return this->packed_values != nullptr;
+}
+
+template<typename FieldValueType>
+FieldValueType const& ChunkField<FieldValueType>::homogeneous_value() const
+{
+	assert(this->is_homogeneous());
+	return this->value_if_homogeneous;
+}
+
+template<typename FieldValueType>
+bool ChunkField<FieldValueType>::make_homogeneous_if_possible()
+{
+	if (this->is_homogeneous())
+	{
+		return true;
+	}
+	else if (this->is_packed())
+	{
+		/* A packed field has at least two values in its palette,
+		 * and its palette only has values that appear in the field. */
+		return false;
+	}
+	ValueType const first_value = this->data[0];
+	unsigned int const volume = this->geometry.volume();
+	for (unsigned int i = 1; i < volume; i++)
+	{
+		if (this->data[i] != first_value)
+		{
+			return false;
+		}
+	}
+	this->data.reset();
+	this->value_if_homogeneous = first_value;
+	return true;
+}
+
+template<typename FieldValueType>
+void ChunkField<FieldValueType>::pack()
+{
+	if (this->data == nullptr)
+	{
+		/* Already homogeneous or packed. */
+		return;
+	}
+
+	/* The palette is small, and consecutive values are often the same,
+	 * so a linear search that starts from the last found value is good enough. */
+	unsigned int const volume = this->geometry.volume();
+	std::vector<ValueType> palette;
+	std::vector<std::uint8_t> index_table(volume);
+	unsigned int palette_index = 0;
+	palette.push_back(this->data[0]);
+	for (unsigned int i = 0; i < volume; i++)
+	{
+		if (palette[palette_index] != this->data[i])
+		{
+			palette_index = std::find(palette.begin(), palette.end(), this->data[i]) -
+				palette.begin();
+			if (palette_index == palette.size())
+			{
+				if (palette.size() == 256)
+				{
+					/* Too many different values to be packed. */
+					return;
+				}
+				palette.push_back(this->data[i]);
+			}
+		}
+		index_table[i] = palette_index;
+	}
+
+	if (palette.size() == 1)
+	{
+		this->make_homogeneous_if_possible();
+		return;
+	}
+
+	std::shared_ptr<PackedValues> packed_values = std::make_shared<PackedValues>();
+	unsigned int const bits_per_value = packed_bits_per_value(palette.size());
+	unsigned int const values_per_word = 64 / bits_per_value;
+	packed_values->bits_per_value = bits_per_value;
+	packed_values->palette = std::move(palette);
+	packed_values->words.resize((volume + values_per_word - 1) / values_per_word, 0);
+	for (unsigned int i = 0; i < volume; i++)
+	{
+		unsigned int const bit_index = i * bits_per_value;
+		packed_values->words[bit_index / 64] |=
+			std::uint64_t{index_table[i]} << (bit_index % 64);
+	}
+	this->data.reset();
+	this->packed_values = std::move(packed_values);
 }
 
 template<typename FieldValueType>
-void ChunkField<FieldValueType>::free_data()
+void ChunkField<FieldValueType>::make_data_unshared()
 {
-	delete[] this->data;
+	if (this->data.use_count() > 1)
+	{
+		unsigned int const volume = this->geometry.volume();
+		std::shared_ptr<ValueType[]> new_data = allocate_data(volume);
+		std::copy_n(this->data.get(), volume, new_data.get());
+		this->data = std::move(new_data);
+	}
 }
 
-template ChunkField<PtgFieldValue>::ChunkField(ChunkCoords chunk_coords);
-template ChunkField<PtgFieldValue>::~ChunkField();
-template PtgFieldValue& ChunkField<PtgFieldValue>::operator[](BlockCoords coords);
-template PtgFieldValue const& ChunkField<PtgFieldValue>::operator[](BlockCoords coords) const;
-template PtgFieldValue* ChunkField<PtgFieldValue>::raw_data();
-template void ChunkField<PtgFieldValue>::free_data();
+template<typename FieldValueType>
+void ChunkField<FieldValueType>::unpack()
+{
+	if (this->data != nullptr)
+	{
+		return;
+	}
+	unsigned int const volume = this->geometry.volume();
+	this->data = allocate_data(volume);
+	if (this->packed_values != nullptr)
+	{
+		for (unsigned int i = 0; i < volume; i++)
+		{
+			this->data[i] = this->packed_values->get(i);
+		}
+		this->packed_values.reset();
+	}
+	else
+	{
+		std::fill_n(this->data.get(), volume, this->value_if_homogeneous);
+	}
+}
 
-template void ChunkField<PttFieldValue>::free_data();
+template<typename FieldValueType>
+std::size_t ChunkField<FieldValueType>::allocated_bytes() const
+{
+	if (this->data != nullptr)
+	{
+		return this->geometry.volume() * sizeof(ValueType);
+	}
+	else if (this->packed_values != nullptr)
+	{
+		return sizeof(PackedValues) +
+			this->packed_values->palette.capacity() * sizeof(ValueType) +
+			this->packed_values->words.capacity() * sizeof(std::uint64_t);
+	}
+	else
+	{
+		return 0;
+	}
+}
 
-template ChunkField<Block>::~ChunkField();
-template Block& ChunkField<Block>::operator[](BlockCoords coords);
-template Block const& ChunkField<Block>::operator[](BlockCoords coords) const;
-template Block* ChunkField<Block>::raw_data();
-template void ChunkField<Block>::free_data();
+template class ChunkField<PtgFieldValue>;
+template class ChunkField<PttFieldValue>;
+template class ChunkField<BFieldValue>;
 
 bool Block::is_air() const
 {
 	return this->type_id == 0;
 }
 
+bool Block::operator==(Block const& other) const
+{
+	return this->type_id == other.type_id;
+}
+
+bool Block::operator!=(Block const& other) const
+{
+	return not (*this == other);
+}
+
 template<typename ChunkFieldType>
 ChunkNeighborhood<ChunkFieldType>::ChunkNeighborhood()
 {
@@ -200,7 +529,7 @@ template<typename ChunkFieldType>
 typename ChunkNeighborhood<ChunkFieldType>::ValueType&
 	ChunkNeighborhood<ChunkFieldType>::operator[](BlockCoords coords)
 {
-	ChunkCoords const chunk_coords = containing_chunk_coords(coords);
+	ChunkCoords const chunk_coords = this->geometry().containing_chunk_coords(coords);
 	ChunkCoords const negativeward_chunk_coords = this->field_table[0].chunk_coords;
 	ChunkCoords const local_chunk_coords = chunk_coords - negativeward_chunk_coords;
 	ChunkFieldType& field = this->field_table[
@@ -211,10 +540,10 @@ typename ChunkNeighborhood<ChunkFieldType>::ValueType&
 }
 
 template<typename ChunkFieldType>
-typename ChunkNeighborhood<ChunkFieldType>::ValueType const&
+typename ChunkNeighborhood<ChunkFieldType>::ValueType
 	ChunkNeighborhood<ChunkFieldType>::operator[](BlockCoords coords) const
 {
-	ChunkCoords const chunk_coords = containing_chunk_coords(coords);
+	ChunkCoords const chunk_coords = this->geometry().containing_chunk_coords(coords);
 	ChunkCoords const negativeward_chunk_coords = this->field_table[0].chunk_coords;
 	ChunkCoords const local_chunk_coords = chunk_coords - negativeward_chunk_coords;
 	ChunkFieldType const& field = this->field_table[
@@ -232,70 +561,394 @@ ChunkRect ChunkNeighborhood<ChunkFieldType>::chunk_rect() const
 		this->field_table[3*3*3-1].chunk_coords};
 }
 
-template ChunkNeighborhood<ChunkPttField>::ValueType const&
+template<typename ChunkFieldType>
+ChunkGeometry ChunkNeighborhood<ChunkFieldType>::geometry() const
+{
+	return this->field_table[0].geometry;
+}
+
+template<typename ChunkFieldType>
+std::optional<typename ChunkNeighborhood<ChunkFieldType>::ValueType>
+	ChunkNeighborhood<ChunkFieldType>::homogeneous_value() const
+{
+	for (FieldType const& field : this->field_table)
+	{
+		if ((not field.is_homogeneous()) ||
+			field.homogeneous_value() != this->field_table[0].homogeneous_value())
+		{
+			return std::nullopt;
+		}
+	}
+	return this->field_table[0].homogeneous_value();
+}
+
+template<typename ChunkFieldType>
+typename ChunkNeighborhood<ChunkFieldType>::FieldType const&
+	ChunkNeighborhood<ChunkFieldType>::field(ChunkCoords offset) const
+{
+	return this->field_table[
+		(offset.x + 1) +
+		(offset.y + 1) * 3 +
+		(offset.z + 1) * 3 * 3];
+}
+
+template<typename ChunkFieldType>
+template<typename ChunkGeometryType>
+typename ChunkNeighborhood<ChunkFieldType>::ValueType
+	ChunkNeighborhood<ChunkFieldType>::get(
+		BlockCoords coords, ChunkGeometryType chunk_geometry) const
+{
+	/* The coords relative to the most negativeward block of the neighborhood
+	 * are all positive, so the divisions round in the right direction. */
+	BlockCoords const local_coords = coords -
+		chunk_geometry.most_negativeward_block_coords(this->field_table[0].chunk_coords);
+	int const side = chunk_geometry.side;
+	ChunkCoords const local_chunk_coords{
+		local_coords.x / side,
+		local_coords.y / side,
+		local_coords.z / side};
+	BlockCoords const coords_in_chunk{
+		local_coords.x - local_chunk_coords.x * side,
+		local_coords.y - local_chunk_coords.y * side,
+		local_coords.z - local_chunk_coords.z * side};
+	ChunkFieldType const& field = this->field_table[
+		local_chunk_coords.x +
+		local_chunk_coords.y * 3 +
+		local_chunk_coords.z * 3 * 3];
+	return field.get(chunk_geometry.local_index(coords_in_chunk));
+}
+
+template class ChunkNeighborhood<ChunkPtgField>;
+template class ChunkNeighborhood<ChunkBField>;
+
+template<typename ChunkFieldType, int Padding>
+PaddedChunkNeighborhood<ChunkFieldType, Padding>::PaddedChunkNeighborhood(
+	ChunkNeighborhood<ChunkFieldType> const& chunk_neighborhood):
+	chunk_coords{chunk_neighborhood.chunk_rect().coords_min + ChunkCoords{1, 1, 1}},
+	geometry{chunk_neighborhood.geometry()},
+	coords_min{this->geometry.most_negativeward_block_coords(this->chunk_coords) -
+		BlockCoords{Padding, Padding, Padding}},
+	data(
+		(this->geometry.side + 2 * Padding) *
+		(this->geometry.side + 2 * Padding) *
+		(this->geometry.side + 2 * Padding))
+{
+	static_assert(Padding >= 0, "Negative padding.");
+	assert(Padding <= this->geometry.side
+		/* The padded cube must fit in the neighborhood. */);
+
+	/* The rows along the x axis are copied in a few contiguous runs,
+	 * one run for each chunk that the row goes through. */
+	int const side = this->geometry.side;
+	int const padded_side = side + 2 * Padding;
+	ValueType* destination = this->data.data();
+	for (int z = 0; z < padded_side; z++)
+	for (int y = 0; y < padded_side; y++)
+	{
+		int x = 0;
+		while (x < padded_side)
+		{
+			BlockCoords const coords = this->coords_min + BlockCoords{x, y, z};
+			ChunkCoords const local_chunk_coords =
+				this->geometry.containing_chunk_coords(coords) -
+				chunk_neighborhood.field_table[0].chunk_coords;
+			ChunkFieldType const& field = chunk_neighborhood.field_table[
+				local_chunk_coords.x +
+				local_chunk_coords.y * 3 +
+				local_chunk_coords.z * 3 * 3];
+			BlockCoords const coords_in_chunk =
+				coords - this->geometry.most_negativeward_block_coords(field.chunk_coords);
+			int const run_length = std::min(side - coords_in_chunk.x, padded_side - x);
+			unsigned int const local_index = this->geometry.local_index(coords_in_chunk);
+			if (field.is_homogeneous())
+			{
+				destination = std::fill_n(destination, run_length, field.homogeneous_value());
+			}
+			else if (field.is_packed())
+			{
+				for (int i = 0; i < run_length; i++)
+				{
+					*destination++ = field.get(local_index + i);
+				}
+			}
+			else
+			{
+				destination = std::copy_n(&field.raw_data()[local_index], run_length, destination);
+			}
+			x += run_length;
+		}
+	}
+}
+
+template<typename ChunkFieldType, int Padding>
+typename PaddedChunkNeighborhood<ChunkFieldType, Padding>::ValueType const&
+	PaddedChunkNeighborhood<ChunkFieldType, Padding>::operator[](BlockCoords coords) const
+{
+	return this->get(coords, this->geometry);
+}
+
+template<typename ChunkFieldType, int Padding>
+template<typename ChunkGeometryType>
+typename PaddedChunkNeighborhood<ChunkFieldType, Padding>::ValueType const&
+	PaddedChunkNeighborhood<ChunkFieldType, Padding>::get(
+		BlockCoords coords, ChunkGeometryType chunk_geometry) const
+{
+	BlockCoords const local_coords = coords - this->coords_min;
+	int const padded_side = chunk_geometry.side + 2 * Padding;
+	return this->data[
+		local_coords.x +
+		local_coords.y * padded_side +
+		local_coords.z * padded_side * padded_side];
+}
+
+template class PaddedChunkNeighborhood<ChunkPtgField, 2>;
+template class PaddedChunkNeighborhood<ChunkBField, 1>;
+
+template ChunkNeighborhood<ChunkPttField>::ValueType
 	ChunkNeighborhood<ChunkPttField>::operator[](BlockCoords coords) const;
 template ChunkRect ChunkNeighborhood<ChunkPttField>::chunk_rect() const;
+template ChunkGeometry ChunkNeighborhood<ChunkPttField>::geometry() const;
+
+namespace
+{
+
+/* Same as `ChunkGeometry` but with the chunk side known at compile-time,
+ * so that the index math and the loop bounds that derive from it are constants.
+ * The chunk generation code is written once for both, see `dispatch_chunk_geometry`. */
+template<int Side>
+class StaticChunkGeometry
+{
+public:
+	static_assert(Side % 2 == 1, "Chunk sides must be odd.");
+	static constexpr int side = Side;
+
+public:
+	operator ChunkGeometry() const;
+
+	constexpr unsigned int volume() const;
+	BlockCoords most_negativeward_block_coords(ChunkCoords chunk_coords) const;
+	constexpr unsigned int local_index(BlockCoords local_coords) const;
+};
+
+template<int Side>
+StaticChunkGeometry<Side>::operator ChunkGeometry() const
+{
+	return ChunkGeometry{Side};
+}
+
+template<int Side>
+constexpr unsigned int StaticChunkGeometry<Side>::volume() const
+{
+	return Side * Side * Side;
+}
+
+template<int Side>
+BlockCoords StaticChunkGeometry<Side>::most_negativeward_block_coords(
+	ChunkCoords chunk_coords) const
+{
+	return BlockCoords{
+		chunk_coords.x * Side - Side / 2,
+		chunk_coords.y * Side - Side / 2,
+		chunk_coords.z * Side - Side / 2};
+}
+
+template<int Side>
+constexpr unsigned int StaticChunkGeometry<Side>::local_index(BlockCoords local_coords) const
+{
+	return
+		local_coords.x +
+		Side * local_coords.y +
+		Side * Side * local_coords.z;
+}
+
+/* Calls the given function with a `StaticChunkGeometry` if the side of the given geometry
+ * is one of the sides for which the chunk generation code is specialized,
+ * or else with the given (run-time) geometry itself which is the generic path.
+ * This happens once per generation step of a chunk, out of the loops over its blocks. */
+template<typename FunctionType>
+auto dispatch_chunk_geometry(ChunkGeometry chunk_geometry, FunctionType function)
+{
+	switch (chunk_geometry.side)
+	{
+		case 15: return function(StaticChunkGeometry<15>{});
+		case 25: return function(StaticChunkGeometry<25>{});
+		case 31: return function(StaticChunkGeometry<31>{});
+		case 33: return function(StaticChunkGeometry<33>{});
+		default: return function(chunk_geometry);
+	}
+}
+
+} /* Anonymous namespace. */
+
+bool chunk_side_is_specialized(int chunk_side)
+{
+	return dispatch_chunk_geometry(ChunkGeometry{chunk_side},
+		[](auto chunk_geometry){
+			return not std::is_same_v<decltype(chunk_geometry), ChunkGeometry>;
+		});
+}
 
 ChunkPtgField generate_chunk_ptg_field(
 	ChunkCoords chunk_coords,
+	ChunkGeometry chunk_geometry,
 	[[maybe_unused]] Nature const& nature)
 {
-	return nature.world_generator.plain_terrain_generator->generate_chunk_ptg_field(
-		chunk_coords, nature);
+	ChunkPtgField ptg_field =
+		nature.world_generator.plain_terrain_generator->generate_chunk_ptg_field(
+			chunk_coords, chunk_geometry, nature);
+	ptg_field.make_homogeneous_if_possible();
+	return ptg_field;
 }
 
-ChunkPttField generate_chunk_ptt_field(
+namespace
+{
+
+/* The neighborhood can be a `ChunkNeighborhood` or a `PaddedChunkNeighborhood`. */
+template<typename ChunkGeometryType, typename NeighborhoodType>
+ChunkPttField generate_chunk_ptt_field_impl(
 	ChunkCoords chunk_coords,
-	ChunkNeighborhood<ChunkPtgField> const chunk_neighborhood_ptg_field,
-	[[maybe_unused]] Nature const& nature)
+	ChunkGeometryType chunk_geometry,
+	NeighborhoodType const& chunk_neighborhood_ptg_field,
+	Nature const& nature)
 {
 	/* Placeholder. */
-	ChunkPttField ptt_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPttField ptt_field{chunk_coords, chunk_geometry};
+	PttFieldValue* const ptt_field_data = ptt_field.raw_data();
+	BlockCoords const coords_min = chunk_geometry.most_negativeward_block_coords(chunk_coords);
+	for (int z = 0; z < chunk_geometry.side; z++)
+	for (int y = 0; y < chunk_geometry.side; y++)
+	for (int x = 0; x < chunk_geometry.side; x++)
 	{
-		if (chunk_neighborhood_ptg_field[coords] >= 2)
+		BlockCoords const coords = coords_min + BlockCoords{x, y, z};
+		auto const ptg_value = [&](BlockCoords coords){
+			return chunk_neighborhood_ptg_field.get(coords, chunk_geometry);
+		};
+		PttFieldValue& ptt_value = ptt_field_data[chunk_geometry.local_index({x, y, z})];
+		if (ptg_value(coords) >= 2)
 		{
-			ptt_field[coords] = 3 + chunk_neighborhood_ptg_field[coords];
+			ptt_value = 3 + ptg_value(coords);
 		}
-		else if (chunk_neighborhood_ptg_field[coords] == 0)
+		else if (ptg_value(coords) == 0)
 		{
-			ptt_field[coords] = 0;
+			ptt_value = 0;
 		}
-		else if (chunk_neighborhood_ptg_field[coords + BlockCoords{0, 0, 1}] == 0 &&
+		else if (ptg_value(coords + BlockCoords{0, 0, 1}) == 0 &&
 			not nature.world_generator.stone_terrain)
 		{
-			ptt_field[coords] = 1;
+			ptt_value = 1;
 		}
-		else if (chunk_neighborhood_ptg_field[coords + BlockCoords{0, 0, 2}] == 0 &&
+		else if (ptg_value(coords + BlockCoords{0, 0, 2}) == 0 &&
 			not nature.world_generator.stone_terrain)
 		{
-			ptt_field[coords] = 2;
+			ptt_value = 2;
 		}
 		else
 		{
-			ptt_field[coords] = 3;
+			ptt_value = 3;
 		}
 	}
 	return ptt_field;
 }
 
+} /* Anonymous namespace. */
+
+ChunkPttField generate_chunk_ptt_field(
+	ChunkCoords chunk_coords,
+	ChunkGeometry chunk_geometry,
+	ChunkNeighborhood<ChunkPtgField> const chunk_neighborhood_ptg_field,
+	Nature const& nature)
+{
+	std::optional<PtgFieldValue> const homogeneous_ptg_value =
+		chunk_neighborhood_ptg_field.homogeneous_value();
+	if (homogeneous_ptg_value.has_value())
+	{
+		/* Same as what `generate_chunk_ptt_field_impl` does for each block, knowing that
+		 * the PTG values above any block are the same as the block's (so not 0 if the
+		 * block's is not 0). */
+		PtgFieldValue const ptg_value = homogeneous_ptg_value.value();
+		PttFieldValue const ptt_value =
+			ptg_value >= 2 ? 3 + ptg_value :
+			ptg_value == 0 ? 0 :
+			3;
+		return ChunkPttField::homogeneous(chunk_coords, chunk_geometry, ptt_value);
+	}
+
+	ChunkPttField ptt_field = dispatch_chunk_geometry(chunk_geometry,
+		[&](auto chunk_geometry){
+			return generate_chunk_ptt_field_impl(
+				chunk_coords, chunk_geometry, chunk_neighborhood_ptg_field, nature);
+		});
+	ptt_field.make_homogeneous_if_possible();
+	return ptt_field;
+}
+
+ChunkPttField generate_chunk_ptt_field(
+	ChunkCoords chunk_coords,
+	ChunkGeometry chunk_geometry,
+	PaddedChunkNeighborhoodPtgField const& padded_neighborhood_ptg_field,
+	Nature const& nature)
+{
+	ChunkPttField ptt_field = dispatch_chunk_geometry(chunk_geometry,
+		[&](auto chunk_geometry){
+			return generate_chunk_ptt_field_impl(
+				chunk_coords, chunk_geometry, padded_neighborhood_ptg_field, nature);
+		});
+	ptt_field.make_homogeneous_if_possible();
+	return ptt_field;
+}
+
+namespace
+{
+
+template<typename ChunkGeometryType>
+void copy_ptt_field_to_b_field(
+	ChunkBField& b_field,
+	ChunkGeometryType chunk_geometry,
+	ChunkNeighborhood<ChunkPttField> const& chunk_neighborhood_ptt_field)
+{
+	BFieldValue* const b_field_data = b_field.raw_data();
+	BlockCoords const coords_min =
+		chunk_geometry.most_negativeward_block_coords(b_field.chunk_coords);
+	for (int z = 0; z < chunk_geometry.side; z++)
+	for (int y = 0; y < chunk_geometry.side; y++)
+	for (int x = 0; x < chunk_geometry.side; x++)
+	{
+		BlockCoords const coords = coords_min + BlockCoords{x, y, z};
+		b_field_data[chunk_geometry.local_index({x, y, z})].type_id =
+			chunk_neighborhood_ptt_field.get(coords, chunk_geometry);
+	}
+}
+
+} /* Anonymous namespace. */
+
 ChunkBField generate_chunk_b_field(
 	ChunkCoords chunk_coords,
+	ChunkGeometry chunk_geometry,
 	ChunkNeighborhood<ChunkPttField> const chunk_neighborhood_ptt_field,
 	[[maybe_unused]] Nature const& nature)
 {
-	/* Placeholder. */
-	ChunkBField b_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	std::optional<PttFieldValue> const homogeneous_ptt_value =
+		chunk_neighborhood_ptt_field.homogeneous_value();
+	if (homogeneous_ptt_value.has_value())
 	{
-		b_field[coords].type_id = chunk_neighborhood_ptt_field[coords];
+		/* Structures start by searching for the ground (some non-air above air),
+		 * which is nowhere to be found in a homogeneous neighborhood. */
+		return ChunkBField::homogeneous(chunk_coords, chunk_geometry,
+			Block{homogeneous_ptt_value.value()});
 	}
 
+	/* Placeholder. */
+	ChunkBField b_field{chunk_coords, chunk_geometry};
+	dispatch_chunk_geometry(chunk_geometry,
+		[&](auto chunk_geometry){
+			copy_ptt_field_to_b_field(b_field, chunk_geometry, chunk_neighborhood_ptt_field);
+		});
+
 	if (nature.world_generator.structures_enabled)
 	{
 		int const structure_bound_rect_max_radius = 12;
 		BlockRect structure_head_rect_of_influence =
-			chunk_rect_block_rect(chunk_neighborhood_ptt_field.chunk_rect());
+			chunk_geometry.chunk_rect_block_rect(chunk_neighborhood_ptt_field.chunk_rect());
 		structure_head_rect_of_influence.coords_min.x += structure_bound_rect_max_radius;
 		structure_head_rect_of_influence.coords_min.y += structure_bound_rect_max_radius;
 		structure_head_rect_of_influence.coords_min.z += structure_bound_rect_max_radius;
@@ -322,53 +975,23 @@ ChunkBField generate_chunk_b_field(
 		}
 	}
 
+	b_field.pack();
 	return b_field;
 }
 
 namespace
 {
 
-/* Generates a piece of mesh data corresponding to the given face of the given block,
- * and adds it to the given mesh. */
-void generate_block_face_in_mesh(
+/* Ambiant occlusion values (from 0 for the darkest to 3 for no occlusion at all)
+ * of the 4 corners of the given face, in the order nn, np, pn, pp (see below). */
+template<typename ChunkGeometryType, typename NeighborhoodType>
+std::array<int, 4> block_face_ambiant_occlusion(
 	BlockFace const& face,
-	Block const& block,
-	ChunkNeighborhood<ChunkBField> const chunk_neighborhood_b_field,
-	Nature const& nature,
-	ChunkMeshData& mesh)
+	ChunkGeometryType chunk_geometry,
+	NeighborhoodType const& chunk_neighborhood_b_field)
 {
 	auto const [index_axis, index_a, index_b] = face.indices_axis_a_b();
 
-	BlockType const& type = nature.block_type_table[block.type_id];
-	AtlasRect atlas_rect = face.axis == Axis::Z ?
-		(face.negativeward ? type.fase_bottom_rect : type.fase_top_rect) :
-		type.fase_vertical_rect;
-
-	bool const reverse_vertex_order =
-		(face.axis == Axis::X && face.negativeward) ||
-		(face.axis == Axis::Y && not face.negativeward) ||
-		(face.axis == Axis::Z && face.negativeward);
-
-	glm::vec2 atlas_coords_min_real = atlas_rect.atlas_coords_min;
-	glm::vec2 atlas_coords_max_real = atlas_rect.atlas_coords_max;
-
-	if ((face.axis == Axis::Y && not face.negativeward) ||
-		(face.axis == Axis::X && face.negativeward))
-	{
-		std::swap(atlas_rect.atlas_coords_min.x, atlas_rect.atlas_coords_max.x);
-	}
-	if (face.axis == Axis::X || face.axis == Axis::Y)
-	{
-		std::swap(atlas_rect.atlas_coords_min.y, atlas_rect.atlas_coords_max.y);
-	}	
-
-	glm::vec3 normal{0.0f, 0.0f, 0.0f};
-	normal[index_axis] = face.negativeward ? -1.0f : 1.0f;
-
-	glm::vec3 coords_nn =
-		static_cast<glm::vec3>(face.internal_coords) - glm::vec3{0.5f, 0.5f, 0.5f};
-	coords_nn[index_axis] += face.negativeward ? 0.0f : 1.0f;
-
 	/* The ambiant occlusion trick used here was taken from 
 	 * https://0fps.net/2013/07/03/ambient-occlusion-for-minecraft-like-worlds/
 	 * this cool blog post seem to be famous in the voxel engine scene. */
@@ -391,7 +1014,7 @@ void generate_block_face_in_mesh(
 		};
 	auto const vertex_ambiant_occlusion_TODO =
 		/* TODO: Make all this less... wierdly presented? */
-		[vertex_ambiant_occlusion, chunk_neighborhood_b_field, face,
+		[vertex_ambiant_occlusion, &chunk_neighborhood_b_field, chunk_geometry, face,
 			index_a=index_a, index_b=index_b]
 		(int a, int b)
 		{
@@ -399,267 +1022,1057 @@ void generate_block_face_in_mesh(
 			BlockCoords coords;
 			coords = external_coords;
 			coords[index_a] += a;
-			bool const side_a = not chunk_neighborhood_b_field[coords].is_air();
+			bool const side_a =
+				not chunk_neighborhood_b_field.get(coords, chunk_geometry).is_air();
 			coords = external_coords;
 			coords[index_b] += b;
-			bool const side_b = not chunk_neighborhood_b_field[coords].is_air();
+			bool const side_b =
+				not chunk_neighborhood_b_field.get(coords, chunk_geometry).is_air();
 			coords = external_coords;
 			coords[index_a] += a;
 			coords[index_b] += b;
-			bool const corner_ab = not chunk_neighborhood_b_field[coords].is_air();
-			int const value = vertex_ambiant_occlusion(side_a, side_b, corner_ab);
-			return static_cast<float>(value) / 3.0f;
+			bool const corner_ab =
+				not chunk_neighborhood_b_field.get(coords, chunk_geometry).is_air();
+			return vertex_ambiant_occlusion(side_a, side_b, corner_ab);
 		};
 
-	VertexDataClassic nn;
-	nn.coords = coords_nn;
-	nn.coords[index_a] += 0.0f;
-	nn.coords[index_b] += 0.0f;
-	nn.normal = normal;
-	nn.atlas_coords.x = atlas_rect.atlas_coords_min.x;
-	nn.atlas_coords.y = atlas_rect.atlas_coords_min.y;
-	nn.atlas_coords_min = atlas_coords_min_real;
-	nn.atlas_coords_max = atlas_coords_max_real;
-	nn.ambiant_occlusion = vertex_ambiant_occlusion_TODO(-1, -1);
-	VertexDataClassic np;
-	np.coords = coords_nn;
-	np.coords[index_a] += 0.0f;
-	np.coords[index_b] += 1.0f;
-	np.normal = normal;
-	np.atlas_coords.x = atlas_rect.atlas_coords_min.x;
-	np.atlas_coords.y = atlas_rect.atlas_coords_max.y;
-	np.atlas_coords_min = atlas_coords_min_real;
-	np.atlas_coords_max = atlas_coords_max_real;
-	np.ambiant_occlusion = vertex_ambiant_occlusion_TODO(-1, +1);
-	VertexDataClassic pn;
-	pn.coords = coords_nn;
-	pn.coords[index_a] += 1.0f;
-	pn.coords[index_b] += 0.0f;
-	pn.normal = normal;
-	pn.atlas_coords.x = atlas_rect.atlas_coords_max.x;
-	pn.atlas_coords.y = atlas_rect.atlas_coords_min.y;
-	pn.atlas_coords_min = atlas_coords_min_real;
-	pn.atlas_coords_max = atlas_coords_max_real;
-	pn.ambiant_occlusion = vertex_ambiant_occlusion_TODO(+1, -1);
-	VertexDataClassic pp;
-	pp.coords = coords_nn;
-	pp.coords[index_a] += 1.0f;
-	pp.coords[index_b] += 1.0f;
-	pp.normal = normal;
-	pp.atlas_coords.x = atlas_rect.atlas_coords_max.x;
-	pp.atlas_coords.y = atlas_rect.atlas_coords_max.y;
-	pp.atlas_coords_min = atlas_coords_min_real;
-	pp.atlas_coords_max = atlas_coords_max_real;
-	pp.ambiant_occlusion = vertex_ambiant_occlusion_TODO(+1, +1);
-
-	/* The four vertices currently corming a square are now being given as two triangles.
-	 * The diagonal of the square (nn-pp or np-pn) that will be the "cut" in the square
-	 * to form triangles is selected based on the ambiant occlusion values of the vertices.
+	return std::array<int, 4>{
+		vertex_ambiant_occlusion_TODO(-1, -1),
+		vertex_ambiant_occlusion_TODO(-1, +1),
+		vertex_ambiant_occlusion_TODO(+1, -1),
+		vertex_ambiant_occlusion_TODO(+1, +1)};
+}
+
+/* Generates a piece of mesh data corresponding to the rectangle of faces that has the given
+ * face of the given block as its most negativeward face and that spans `extent_a` faces
+ * along the "a" axis of the face and `extent_b` faces along its "b" axis,
+ * and adds it to the given mesh of the chunk that has the given most negativeward block.
+ * All the faces of the rectangle are expected to look the same,
+ * the texture of the block type is repeated over them (by the shader). */
+void generate_face_rect_in_mesh(
+	BlockFace const& face,
+	int extent_a,
+	int extent_b,
+	Block const& block,
+	std::array<int, 4> const& ambiant_occlusion,
+	BlockCoords chunk_coords_min,
+	ChunkMeshData& mesh)
+{
+	auto const [index_axis, index_a, index_b] = face.indices_axis_a_b();
+
+	bool const reverse_vertex_order =
+		(face.axis == Axis::X && face.negativeward) ||
+		(face.axis == Axis::Y && not face.negativeward) ||
+		(face.axis == Axis::Z && face.negativeward);
+
+	/* Chunk-local coords of the vertices are coords of block corners, with the most
+	 * negativeward corner of the chunk being (0, 0, 0). */
+	BlockCoords local_coords_nn = face.internal_coords - chunk_coords_min;
+	local_coords_nn[index_axis] += face.negativeward ? 0 : 1;
+	unsigned int const face_id = index_axis * 2 + (face.negativeward ? 1 : 0);
+	auto const vertex = [&, index_a=index_a, index_b=index_b]
+		(int offset_a, int offset_b, int vertex_ambiant_occlusion){
+			BlockCoords local_coords = local_coords_nn;
+			local_coords[index_a] += offset_a;
+			local_coords[index_b] += offset_b;
+			return VertexDataChunk{
+				static_cast<unsigned int>(local_coords.x),
+				static_cast<unsigned int>(local_coords.y),
+				static_cast<unsigned int>(local_coords.z),
+				face_id, static_cast<unsigned int>(vertex_ambiant_occlusion), block.type_id};
+		};
+	VertexDataChunk const nn = vertex(0, 0, ambiant_occlusion[0]);
+	VertexDataChunk const np = vertex(0, extent_b, ambiant_occlusion[1]);
+	VertexDataChunk const pn = vertex(extent_a, 0, ambiant_occlusion[2]);
+	VertexDataChunk const pp = vertex(extent_a, extent_b, ambiant_occlusion[3]);
+
+	/* The four vertices currently corming a square are given as a quad, that is drawn as the
+	 * two triangles 0-1-2 and 0-2-3 (see `bind_quad_index_buffer`), so vertices 0 and 2 are
+	 * the ends of the diagonal of the square (nn-pp or np-pn) that will be the "cut".
+	 * The diagonal is selected based on the ambiant occlusion values of the vertices.
 	 * Depending on the diagonal picked, the ambiant occlusion behaves differently on the face,
 	 * and we make sure that this behavior is consistent. */
 	bool const other_triangle_cut =
-		nn.ambiant_occlusion + pp.ambiant_occlusion <= np.ambiant_occlusion + pn.ambiant_occlusion;
-	std::array<VertexDataClassic, 6> const vertex_data_sequence =
+		ambiant_occlusion[0] + ambiant_occlusion[3] <= ambiant_occlusion[1] + ambiant_occlusion[2];
+	std::array<VertexDataChunk, 4> const quad =
 		other_triangle_cut ?
-			std::array<VertexDataClassic, 6>{np, nn, pn, np, pn, pp} :
-			std::array<VertexDataClassic, 6>{nn, pn, pp, nn, pp, np};
-	
-	/* Does std::copy preallocate the appropriate size ? Probably...
-	 * TODO: Find out and remove this std::vector::reserve call if redundant. */
-	mesh.reserve(mesh.size() + vertex_data_sequence.size());
+			std::array<VertexDataChunk, 4>{np, nn, pn, pp} :
+			std::array<VertexDataChunk, 4>{nn, pn, pp, np};
+
+	/* Reversing the vertex order flips the winding (for face culling), but it must keep the
+	 * diagonal, so vertex 0 stays in place and the other three are reversed. */
 	if (reverse_vertex_order)
 	{
-		std::copy(vertex_data_sequence.rbegin(), vertex_data_sequence.rend(),
-			std::back_inserter(mesh));
+		mesh.insert(mesh.end(), {quad[0], quad[3], quad[2], quad[1]});
 	}
 	else
 	{
-		std::copy(vertex_data_sequence.begin(), vertex_data_sequence.end(),
-			std::back_inserter(mesh));
+		mesh.insert(mesh.end(), quad.begin(), quad.end());
 	}
 }
 
-} /* Anonymous namespace. */
+/* Generates a piece of mesh data corresponding to the given face of the given block,
+ * and adds it to the given mesh. */
+template<typename ChunkGeometryType, typename NeighborhoodType>
+void generate_block_face_in_mesh(
+	BlockFace const& face,
+	Block const& block,
+	ChunkGeometryType chunk_geometry,
+	NeighborhoodType const& chunk_neighborhood_b_field,
+	BlockCoords chunk_coords_min,
+	ChunkMeshData& mesh)
+{
+	generate_face_rect_in_mesh(face, 1, 1, block,
+		block_face_ambiant_occlusion(face, chunk_geometry, chunk_neighborhood_b_field),
+		chunk_coords_min, mesh);
+}
 
-ChunkMeshData* generate_chunk_complete_mesh(
-	ChunkCoords chunk_coords,
-	ChunkNeighborhood<ChunkBField> const chunk_neighborhood_b_field,
-	Nature const& nature)
+/* Generates the pieces of mesh data corresponding to the visible faces of the block
+ * at the given coords, and adds them to the given mesh. */
+template<typename ChunkGeometryType, typename NeighborhoodType>
+void generate_block_faces_in_mesh(
+	BlockCoords coords_interior,
+	ChunkGeometryType chunk_geometry,
+	NeighborhoodType const& chunk_neighborhood_b_field,
+	BlockCoords chunk_coords_min,
+	ChunkMeshData& mesh)
 {
-	ChunkMeshData* mesh_data = new ChunkMeshData{};
-	for (BlockCoords coords_interior : chunk_block_rect(chunk_coords))
+	Block const& block_interior =
+		chunk_neighborhood_b_field.get(coords_interior, chunk_geometry);
+	if (block_interior.is_air())
+	{
+		return;
+	}
+
+	for (Axis axis : {Axis::X, Axis::Y, Axis::Z})
+	for (bool negativeward : {false, true})
 	{
-		Block const& block_interior = chunk_neighborhood_b_field[coords_interior];
-		if (block_interior.is_air())
+		BlockCoords coords_exterior;
+		coords_exterior = coords_interior;
+		coords_exterior[static_cast<unsigned int>(axis)] += negativeward ? -1 : +1;
+		Block const& block_exterior =
+			chunk_neighborhood_b_field.get(coords_exterior, chunk_geometry);
+		if (not block_exterior.is_air())
 		{
 			continue;
 		}
 
-		for (Axis axis : {Axis::X, Axis::Y, Axis::Z})
-		for (bool negativeward : {false, true})
+		generate_block_face_in_mesh(
+			BlockFace{coords_interior, axis, negativeward},
+			block_interior,
+			chunk_geometry,
+			chunk_neighborhood_b_field,
+			chunk_coords_min,
+			mesh);
+	}
+}
+
+/* Meshing that emits one quad per visible block face.
+ * If `block_table` is not null, then it is filled with the range of quads of each block.
+ * The neighborhood can be a `ChunkNeighborhood` or a `PaddedChunkNeighborhood`. */
+template<typename ChunkGeometryType, typename NeighborhoodType>
+void generate_chunk_complete_mesh_impl(
+	ChunkMeshData& mesh_data,
+	ChunkCoords chunk_coords,
+	ChunkGeometryType chunk_geometry,
+	NeighborhoodType const& chunk_neighborhood_b_field,
+	[[maybe_unused]] Nature const& nature,
+	ChunkMeshBlockTable* block_table = nullptr)
+{
+	BlockCoords const coords_min = chunk_geometry.most_negativeward_block_coords(chunk_coords);
+	for (int z = 0; z < chunk_geometry.side; z++)
+	for (int y = 0; y < chunk_geometry.side; y++)
+	for (int x = 0; x < chunk_geometry.side; x++)
+	{
+		std::uint32_t const first_quad = mesh_data.size() / 4;
+		generate_block_faces_in_mesh(coords_min + BlockCoords{x, y, z},
+			chunk_geometry, chunk_neighborhood_b_field, coords_min, mesh_data);
+		if (block_table != nullptr)
+		{
+			std::uint32_t const quad_count = mesh_data.size() / 4 - first_quad;
+			block_table->block_range_table[chunk_geometry.local_index({x, y, z})] =
+				ChunkMeshBlockTable::QuadRange{first_quad, quad_count};
+		}
+	}
+}
+
+/* Greedy meshing, which merges rectangles of visible faces that look the same
+ * (same block type and same uniform ambiant occlusion) into single quads.
+ * Each slice of the chunk along each axis (and for both face orientations) is processed
+ * by first marking the visible faces in a 2D mask, and then by covering the mask with
+ * rectangles that are grown along the "a" axis first and then along the "b" axis.
+ * Faces that have a non-uniform ambiant occlusion would not look the same if merged
+ * (the ambiant occlusion is interpolated between the corners of the quads)
+ * so these are not put in the mask and get their own quad right away.
+ * The neighborhood can be a `ChunkNeighborhood` or a `PaddedChunkNeighborhood`. */
+template<typename ChunkGeometryType, typename NeighborhoodType>
+void generate_chunk_greedy_mesh_impl(
+	ChunkMeshData& mesh_data,
+	ChunkCoords chunk_coords,
+	ChunkGeometryType chunk_geometry,
+	NeighborhoodType const& chunk_neighborhood_b_field,
+	[[maybe_unused]] Nature const& nature)
+{
+	/* A mask key of zero means that there is no face to mesh there,
+	 * other keys encode the block type and the ambiant occlusion of the face. */
+	using MaskKey = std::uint32_t;
+	auto const mask_key = [](BlockTypeId type_id, int ambiant_occlusion){
+		return ((static_cast<MaskKey>(type_id) + 1) << 2) | static_cast<MaskKey>(ambiant_occlusion);
+	};
+	int const side = chunk_geometry.side;
+	std::vector<MaskKey> mask(side * side);
+
+	BlockCoords const coords_min = chunk_geometry.most_negativeward_block_coords(chunk_coords);
+	for (Axis axis : {Axis::X, Axis::Y, Axis::Z})
+	for (bool negativeward : {false, true})
+	{
+		auto const [index_axis, index_a, index_b] =
+			BlockFace{coords_min, axis, negativeward}.indices_axis_a_b();
+		auto const slice_coords = [&, index_axis=index_axis, index_a=index_a, index_b=index_b]
+			(int slice, int a, int b){
+				BlockCoords coords = coords_min;
+				coords[index_axis] += slice;
+				coords[index_a] += a;
+				coords[index_b] += b;
+				return coords;
+			};
+
+		for (int slice = 0; slice < side; slice++)
 		{
-			BlockCoords coords_exterior;
-			coords_exterior = coords_interior;
-			coords_exterior[static_cast<unsigned int>(axis)] += negativeward ? -1 : +1;
-			Block const& block_exterior = chunk_neighborhood_b_field[coords_exterior];
-			if (not block_exterior.is_air())
+			for (int b = 0; b < side; b++)
+			for (int a = 0; a < side; a++)
 			{
-				continue;
+				MaskKey& key = mask[a + side * b];
+				key = 0;
+				BlockCoords const coords_interior = slice_coords(slice, a, b);
+				Block const& block_interior =
+					chunk_neighborhood_b_field.get(coords_interior, chunk_geometry);
+				if (block_interior.is_air())
+				{
+					continue;
+				}
+				BlockCoords coords_exterior = coords_interior;
+				coords_exterior[index_axis] += negativeward ? -1 : +1;
+				if (not chunk_neighborhood_b_field.get(coords_exterior, chunk_geometry).is_air())
+				{
+					continue;
+				}
+
+				BlockFace const face{coords_interior, axis, negativeward};
+				std::array<int, 4> const ambiant_occlusion =
+					block_face_ambiant_occlusion(face, chunk_geometry, chunk_neighborhood_b_field);
+				bool const uniform_ambiant_occlusion =
+					ambiant_occlusion[0] == ambiant_occlusion[1] &&
+					ambiant_occlusion[0] == ambiant_occlusion[2] &&
+					ambiant_occlusion[0] == ambiant_occlusion[3];
+				if (uniform_ambiant_occlusion)
+				{
+					key = mask_key(block_interior.type_id, ambiant_occlusion[0]);
+				}
+				else
+				{
+					generate_face_rect_in_mesh(face, 1, 1, block_interior, ambiant_occlusion,
+						coords_min, mesh_data);
+				}
 			}
 
-			generate_block_face_in_mesh(
-				BlockFace{coords_interior, axis, negativeward},
-				block_interior,
-				chunk_neighborhood_b_field,
-				nature,
-				*mesh_data);
+			for (int b = 0; b < side; b++)
+			for (int a = 0; a < side; a++)
+			{
+				MaskKey const key = mask[a + side * b];
+				if (key == 0)
+				{
+					continue;
+				}
+
+				int extent_a = 1;
+				while (a + extent_a < side && mask[a + extent_a + side * b] == key)
+				{
+					extent_a++;
+				}
+				int extent_b = 1;
+				while (b + extent_b < side)
+				{
+					MaskKey const* const row = &mask[a + side * (b + extent_b)];
+					if (not std::all_of(row, row + extent_a,
+						[key](MaskKey other_key){ return other_key == key; }))
+					{
+						break;
+					}
+					extent_b++;
+				}
+				for (int rect_b = b; rect_b < b + extent_b; rect_b++)
+				{
+					std::fill_n(&mask[a + side * rect_b], extent_a, 0);
+				}
+
+				Block const block{static_cast<BlockTypeId>((key >> 2) - 1)};
+				int const ambiant_occlusion = static_cast<int>(key & 3);
+				generate_face_rect_in_mesh(
+					BlockFace{slice_coords(slice, a, b), axis, negativeward},
+					extent_a, extent_b, block,
+					{ambiant_occlusion, ambiant_occlusion, ambiant_occlusion, ambiant_occlusion},
+					coords_min, mesh_data);
+			}
 		}
 	}
-	return mesh_data;
 }
 
-ChunkEntityTable::ChunkEntityTable()
+/* Generates the mesh of a chunk with either of the meshing methods. */
+template<typename NeighborhoodType>
+ChunkMeshData* generate_chunk_mesh_with_method(
+	ChunkCoords chunk_coords,
+	ChunkGeometry chunk_geometry,
+	NeighborhoodType const& chunk_neighborhood_b_field,
+	Nature const& nature,
+	bool greedy_meshing)
 {
-	;	
+	ChunkMeshData* mesh_data = new ChunkMeshData{};
+	dispatch_chunk_geometry(chunk_geometry,
+		[&](auto chunk_geometry){
+			if (greedy_meshing)
+			{
+				generate_chunk_greedy_mesh_impl(*mesh_data,
+					chunk_coords, chunk_geometry, chunk_neighborhood_b_field, nature);
+			}
+			else
+			{
+				generate_chunk_complete_mesh_impl(*mesh_data,
+					chunk_coords, chunk_geometry, chunk_neighborhood_b_field, nature);
+			}
+		});
+	return mesh_data;
 }
 
-namespace
+/* Remeshes only the block at the given coords in the given chunk mesh, in the range of
+ * quads that the given block table says is owned by that block (or in a new range if the
+ * block now requires more quads than before). Unused quads are made degenerate. */
+void remesh_block_in_chunk_mesh(
+	BlockCoords coords,
+	ChunkCoords chunk_coords,
+	ChunkGeometry chunk_geometry,
+	ChunkNeighborhood<ChunkBField> const& chunk_neighborhood_b_field,
+	ChunkMeshBlockTable& block_table,
+	Mesh<VertexDataChunk>& mesh)
 {
+	BlockCoords const coords_min = chunk_geometry.most_negativeward_block_coords(chunk_coords);
+	ChunkMeshData block_mesh_data;
+	generate_block_faces_in_mesh(coords, chunk_geometry, chunk_neighborhood_b_field,
+		coords_min, block_mesh_data);
+	std::uint32_t const quad_count = block_mesh_data.size() / 4;
+
+	VertexDataChunk const degenerate_vertex{0, 0, 0, 0, 0, 0};
+	ChunkMeshBlockTable::QuadRange& range =
+		block_table.block_range_table[chunk_geometry.local_index(coords - coords_min)];
+	if (range.quad_count < quad_count)
+	{
+		/* The old range is too small, it is cleared and becomes a hole. */
+		std::fill(
+			mesh.vertex_data.begin() + range.first_quad * 4,
+			mesh.vertex_data.begin() + (range.first_quad + range.quad_count) * 4,
+			degenerate_vertex);
+		mesh.mark_dirty_range(range.first_quad * 4, (range.first_quad + range.quad_count) * 4);
+		if (range.quad_count != 0)
+		{
+			block_table.hole_table.push_back(range);
+		}
+		range = block_table.allocate_range(quad_count, mesh.vertex_data);
+	}
 
-std::string chunk_file_name(ChunkCoords chunk_coords)
-{
-	std::stringstream file_name_stream;
-	file_name_stream << "saves/" << g_game->save_name << "/chunks/chunk_"
-		<< chunk_coords.x << "_" << chunk_coords.y << "_" << chunk_coords.z
-		<< ".qwy2_chunk";
-	return file_name_stream.str();
+	auto const range_begin = mesh.vertex_data.begin() + range.first_quad * 4;
+	std::copy(block_mesh_data.cbegin(), block_mesh_data.cend(), range_begin);
+	std::fill(range_begin + quad_count * 4, range_begin + range.quad_count * 4,
+		degenerate_vertex);
+	mesh.mark_dirty_range(range.first_quad * 4, (range.first_quad + range.quad_count) * 4);
 }
 
 } /* Anonymous namespace. */
 
-ChunkDiskStorage::ChunkDiskStorage()
+ChunkMeshData* generate_chunk_complete_mesh(
+	ChunkCoords chunk_coords,
+	ChunkGeometry chunk_geometry,
+	ChunkNeighborhood<ChunkBField> const chunk_neighborhood_b_field,
+	Nature const& nature,
+	bool greedy_meshing)
 {
-	assert(false
-		/* This default constructor is required by the `std::unsorted_map<ChunkDiskStorage>`
-		 * but it makes no sense and should never be called. */);
-	std::exit(EXIT_FAILURE);
+	if (chunk_mesh_is_trivially_empty(chunk_neighborhood_b_field))
+	{
+		return new ChunkMeshData{};
+	}
+	return generate_chunk_mesh_with_method(
+		chunk_coords, chunk_geometry, chunk_neighborhood_b_field, nature, greedy_meshing);
 }
 
-ChunkDiskStorage::ChunkDiskStorage(ChunkCoords chunk_coords):
-	chunk_coords(chunk_coords), modified(false), file_name(chunk_file_name(chunk_coords))
+ChunkMeshData* generate_chunk_complete_mesh(
+	ChunkCoords chunk_coords,
+	ChunkGeometry chunk_geometry,
+	PaddedChunkNeighborhoodBField const& padded_neighborhood_b_field,
+	Nature const& nature,
+	bool greedy_meshing)
 {
-	this->exist = std::ifstream{this->file_name, std::ifstream::binary}.good();
+	return generate_chunk_mesh_with_method(
+		chunk_coords, chunk_geometry, padded_neighborhood_b_field, nature, greedy_meshing);
 }
 
-ChunkDiskStorage search_disk_for_chunk(ChunkCoords chunk_coords)
+ChunkMeshBlockTable::ChunkMeshBlockTable(ChunkGeometry chunk_geometry):
+	block_range_table(chunk_geometry.volume(), QuadRange{0, 0})
 {
-	ChunkDiskStorage storage{chunk_coords};
-	return storage;
+	;
 }
 
-ChunkBField read_disk_chunk_b_field(ChunkCoords chunk_coords,
-	ChunkDiskStorage& chunk_disk_storage)
+ChunkMeshBlockTable::QuadRange ChunkMeshBlockTable::allocate_range(
+	std::uint32_t quad_count, ChunkMeshData& mesh)
 {
-	/* TODO: Make this better. */
-	unsigned int const size = sizeof (Block) * chunk_volume();
-	Block* b_field_data = static_cast<Block*>(operator new(size));
-	std::fstream file{chunk_disk_storage.file_name,
-		std::ios::binary | std::ios::in | std::ios::out};
-	file.read(static_cast<char*>(static_cast<void*>(b_field_data)), size);
-	ChunkBField b_field{chunk_coords, b_field_data};
-	return b_field;
+	for (unsigned int i = 0; i < this->hole_table.size(); i++)
+	{
+		QuadRange& hole = this->hole_table[i];
+		if (quad_count <= hole.quad_count)
+		{
+			QuadRange const range{hole.first_quad, quad_count};
+			hole.first_quad += quad_count;
+			hole.quad_count -= quad_count;
+			if (hole.quad_count == 0)
+			{
+				hole = this->hole_table.back();
+				this->hole_table.pop_back();
+			}
+			return range;
+		}
+	}
+
+	QuadRange const range{static_cast<std::uint32_t>(mesh.size() / 4), quad_count};
+	mesh.resize(mesh.size() + quad_count * 4, VertexDataChunk{0, 0, 0, 0, 0, 0});
+	return range;
+}
+
+ChunkMeshData* generate_chunk_complete_mesh_and_block_table(
+	ChunkCoords chunk_coords,
+	ChunkGeometry chunk_geometry,
+	ChunkNeighborhood<ChunkBField> const chunk_neighborhood_b_field,
+	Nature const& nature,
+	ChunkMeshBlockTable& block_table)
+{
+	ChunkMeshData* mesh_data = new ChunkMeshData{};
+	if (chunk_mesh_is_trivially_empty(chunk_neighborhood_b_field))
+	{
+		/* All the blocks have an empty range in the block table. */
+		return mesh_data;
+	}
+	dispatch_chunk_geometry(chunk_geometry,
+		[&](auto chunk_geometry){
+			generate_chunk_complete_mesh_impl(*mesh_data,
+				chunk_coords, chunk_geometry, chunk_neighborhood_b_field, nature, &block_table);
+		});
+	return mesh_data;
 }
 
-void write_disk_chunk_b_field(ChunkCoords chunk_coords,
-	ChunkDiskStorage& chunk_disk_storage, ChunkBField chunk_b_field)
+bool chunk_mesh_is_trivially_empty(
+	ChunkNeighborhood<ChunkBField> const& chunk_neighborhood_b_field)
 {
-	/* TODO: Make this better. */
-	//std::cout << chunk_disk_storage.file_name << std::endl;
-	std::fstream file;
-	if (chunk_disk_storage.exist)
+	ChunkBField const& b_field = chunk_neighborhood_b_field.field(ChunkCoords{0, 0, 0});
+	if (not b_field.is_homogeneous())
 	{
-		file.open(chunk_disk_storage.file_name,
-			std::ios::binary | std::ios::in | std::ios::out);
+		return false;
 	}
-	else
+	else if (b_field.homogeneous_value().is_air())
 	{
-		file.open(chunk_disk_storage.file_name,
-			std::ios::binary | std::ios::out);
+		/* Air has no faces. */
+		return true;
 	}
-	file.seekp(0, std::ios_base::beg);
-	unsigned int const size = sizeof (Block) * chunk_volume();
-	file.write(static_cast<char*>(static_cast<void*>(chunk_b_field.raw_data())), size);
-	file.flush();
-	file.close();
 
-	chunk_disk_storage.modified = false;
+	/* The chunk is full of non-air blocks, their faces are all hidden if the layers of
+	 * blocks that touch the faces of the chunk are non-air too. */
+	for (int axis = 0; axis < 3; axis++)
+	for (int direction : {-1, 1})
+	{
+		ChunkCoords offset{0, 0, 0};
+		offset[axis] = direction;
+		ChunkBField const& neighbor_b_field = chunk_neighborhood_b_field.field(offset);
+		if (neighbor_b_field.is_homogeneous())
+		{
+			if (neighbor_b_field.homogeneous_value().is_air())
+			{
+				return false;
+			}
+			continue;
+		}
+		BlockRect touching_layer = b_field.geometry.block_rect(neighbor_b_field.chunk_coords);
+		if (direction == 1)
+		{
+			touching_layer.coords_max[axis] = touching_layer.coords_min[axis];
+		}
+		else
+		{
+			touching_layer.coords_min[axis] = touching_layer.coords_max[axis];
+		}
+		for (BlockCoords coords : touching_layer)
+		{
+			if (neighbor_b_field[coords].is_air())
+			{
+				return false;
+			}
+		}
+	}
+	return true;
 }
 
-bool ChunkGrid::has_ptg_field(ChunkCoords chunk_coords) const
+ChunkEntityTable::ChunkEntityTable()
 {
-	return this->ptg_field.find(chunk_coords) != this->ptg_field.end();
+	;	
 }
 
-bool ChunkGrid::has_ptt_field(ChunkCoords chunk_coords) const
+ChunkSaveSignature::ChunkSaveSignature():
+	chunk_side{0}, terrain_generator_id{0}, seed{0}
 {
-	return this->ptt_field.find(chunk_coords) != this->ptt_field.end();
+	;
 }
 
-bool ChunkGrid::has_b_field(ChunkCoords chunk_coords) const
+namespace
 {
-	return this->b_field.find(chunk_coords) != this->b_field.end();
-}
 
-bool ChunkGrid::has_complete_mesh(ChunkCoords chunk_coords) const
+/* FNV-1a, 32 bits. */
+std::uint32_t name_hash(std::string_view name)
 {
-	return this->mesh.find(chunk_coords) != this->mesh.end();
+	std::uint32_t hash = 2166136261u;
+	for (char c : name)
+	{
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 16777619u;
+	}
+	return hash;
 }
 
-bool ChunkGrid::has_entity_table(ChunkCoords chunk_coords) const
+} /* Anonymous namespace. */
+
+ChunkSaveSignature::ChunkSaveSignature(ChunkGeometry chunk_geometry,
+	std::string_view terrain_generator_name, int seed
+):
+	chunk_side{chunk_geometry.side},
+	terrain_generator_id{name_hash(terrain_generator_name)},
+	seed{seed}
 {
-	return this->entity_table.find(chunk_coords) != this->entity_table.end();
+	;
 }
 
-bool ChunkGrid::has_disk_storage(ChunkCoords chunk_coords) const
+namespace
 {
-	return this->disk.find(chunk_coords) != this->disk.end();
-}
 
-bool ChunkGrid::has_ptg_field_neighborhood(ChunkCoords center_chunk_coords) const
+/* Starts the saved data of a chunk (in native byte order). */
+class ChunkSaveHeader
 {
-	for (int dx = -1; dx <= 1; dx++)
-	for (int dy = -1; dy <= 1; dy++)
-	for (int dz = -1; dz <= 1; dz++)
-	{
-		ChunkCoords const chunk_coords = center_chunk_coords + ChunkCoords{dx, dy, dz};
-		auto iterator = this->ptg_field.find(chunk_coords);
-		if (iterator == this->ptg_field.end())
+public:
+	char magic[4];
+	std::uint32_t format_version;
+	std::int32_t chunk_side;
+	std::uint32_t terrain_generator_id;
+	std::int32_t seed;
+	/* Of the compressed B field that follows the header. */
+	std::uint32_t payload_byte_size;
+	std::uint32_t payload_checksum;
+};
+
+/* Raw B fields (saved before there was a header) begin with block type ids that are way
+ * smaller than what these magic bytes would make, so there is no ambiguity. */
+constexpr char CHUNK_SAVE_MAGIC[4] = {'Q', '2', 'C', 'B'};
+constexpr std::uint32_t CHUNK_SAVE_FORMAT_VERSION = 1;
+
+/* CRC-32 (the one of zlib and PNG). */
+std::uint32_t crc32(char const* data, std::size_t size)
+{
+	static std::array<std::uint32_t, 256> const table = [](){
+		std::array<std::uint32_t, 256> table;
+		for (std::uint32_t i = 0; i < 256; i++)
 		{
-			return false;
+			std::uint32_t value = i;
+			for (unsigned int j = 0; j < 8; j++)
+			{
+				value = (value & 1) ? (0xedb88320u ^ (value >> 1)) : (value >> 1);
+			}
+			table[i] = value;
 		}
+		return table;
+	}();
+	std::uint32_t crc = 0xffffffffu;
+	for (std::size_t i = 0; i < size; i++)
+	{
+		crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xff] ^ (crc >> 8);
 	}
-	return true;
+	return crc ^ 0xffffffffu;
 }
 
-bool ChunkGrid::has_ptt_field_neighborhood(ChunkCoords center_chunk_coords) const
+/* Integers in the compressed B field are written 7 bits per byte, the high bit of each
+ * byte telling if more bytes follow, so that the small ones (that are the common case)
+ * take only one byte. */
+void write_varint(std::vector<char>& data, std::uint32_t value)
 {
-	for (int dx = -1; dx <= 1; dx++)
-	for (int dy = -1; dy <= 1; dy++)
-	for (int dz = -1; dz <= 1; dz++)
+	while (value >= 0x80)
 	{
-		ChunkCoords const chunk_coords = center_chunk_coords + ChunkCoords{dx, dy, dz};
-		auto iterator = this->ptt_field.find(chunk_coords);
-		if (iterator == this->ptt_field.end())
-		{
-			return false;
-		}
+		data.push_back(static_cast<char>((value & 0x7f) | 0x80));
+		value >>= 7;
 	}
-	return true;
+	data.push_back(static_cast<char>(value));
 }
 
-bool ChunkGrid::has_b_field_neighborhood(ChunkCoords center_chunk_coords) const
+/* Returns false if the data ends before the integer does. */
+bool read_varint(char const*& cursor, char const* end, std::uint32_t& value)
 {
-	for (int dx = -1; dx <= 1; dx++)
+	value = 0;
+	for (unsigned int shift = 0; shift < 32; shift += 7)
+	{
+		if (cursor == end)
+		{
+			return false;
+		}
+		unsigned char const byte = static_cast<unsigned char>(*cursor++);
+		value |= static_cast<std::uint32_t>(byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+[[noreturn]] void saved_chunk_error(ChunkCoords chunk_coords, std::string_view reason)
+{
+	std::cout << "\x1b[31mError:\x1b[39m "
+		<< "Failed to load the saved B field of the chunk " << chunk_coords << ", "
+		<< reason << "."
+		<< std::endl;
+	assert(false);
+	std::exit(EXIT_FAILURE);
+}
+
+/* Only warned about once, as it would typically concern all the saved chunks. */
+std::atomic_flag g_signature_mismatch_warned = ATOMIC_FLAG_INIT;
+
+} /* Anonymous namespace. */
+
+std::vector<char> serialize_chunk_b_field(ChunkBField const& chunk_b_field,
+	ChunkSaveSignature const& save_signature)
+{
+	/* The palette gets the block types in order of appearance. */
+	unsigned int const volume = chunk_b_field.geometry.volume();
+	std::vector<BlockTypeId> palette;
+	std::vector<char> payload;
+	std::vector<std::pair<std::uint32_t, std::uint32_t>> run_table;
+	for (unsigned int i = 0; i < volume; i++)
+	{
+		BlockTypeId const type_id = chunk_b_field.get(i).type_id;
+		auto const palette_iterator = std::find(palette.begin(), palette.end(), type_id);
+		std::uint32_t const palette_index = palette_iterator - palette.begin();
+		if (palette_iterator == palette.end())
+		{
+			palette.push_back(type_id);
+		}
+		if ((not run_table.empty()) && run_table.back().second == palette_index)
+		{
+			run_table.back().first++;
+		}
+		else
+		{
+			run_table.push_back(std::make_pair(1, palette_index));
+		}
+	}
+	write_varint(payload, palette.size());
+	for (BlockTypeId type_id : palette)
+	{
+		write_varint(payload, type_id);
+	}
+	for (auto const& [run_length, palette_index] : run_table)
+	{
+		write_varint(payload, run_length);
+		write_varint(payload, palette_index);
+	}
+
+	ChunkSaveHeader header;
+	std::memcpy(header.magic, CHUNK_SAVE_MAGIC, sizeof header.magic);
+	header.format_version = CHUNK_SAVE_FORMAT_VERSION;
+	header.chunk_side = save_signature.chunk_side;
+	header.terrain_generator_id = save_signature.terrain_generator_id;
+	header.seed = save_signature.seed;
+	header.payload_byte_size = payload.size();
+	header.payload_checksum = crc32(payload.data(), payload.size());
+	std::vector<char> data(sizeof header + payload.size());
+	std::memcpy(data.data(), &header, sizeof header);
+	std::memcpy(data.data() + sizeof header, payload.data(), payload.size());
+	return data;
+}
+
+ChunkBField deserialize_chunk_b_field(ChunkCoords chunk_coords, ChunkGeometry chunk_geometry,
+	char const* data, std::size_t byte_size, ChunkSaveSignature const& save_signature)
+{
+	unsigned int const volume = chunk_geometry.volume();
+	bool const has_header =
+		byte_size >= sizeof (ChunkSaveHeader) &&
+		std::memcmp(data, CHUNK_SAVE_MAGIC, sizeof CHUNK_SAVE_MAGIC) == 0;
+	if (not has_header)
+	{
+		/* Saved before there was a header, so it is a raw B field. */
+		if (byte_size != sizeof (Block) * volume)
+		{
+			saved_chunk_error(chunk_coords, "its size does not match the chunk side");
+		}
+		ChunkBField b_field{chunk_coords, chunk_geometry};
+		std::memcpy(b_field.raw_data(), data, byte_size);
+		b_field.pack();
+		return b_field;
+	}
+
+	ChunkSaveHeader header;
+	std::memcpy(&header, data, sizeof header);
+	if (header.format_version != CHUNK_SAVE_FORMAT_VERSION)
+	{
+		saved_chunk_error(chunk_coords, "it was saved in an unknown format version");
+	}
+	if (header.chunk_side != chunk_geometry.side)
+	{
+		saved_chunk_error(chunk_coords, "it was saved with an other chunk side");
+	}
+	char const* cursor = data + sizeof header;
+	char const* const end = data + byte_size;
+	if (static_cast<std::size_t>(end - cursor) != header.payload_byte_size ||
+		crc32(cursor, header.payload_byte_size) != header.payload_checksum)
+	{
+		saved_chunk_error(chunk_coords, "its data is corrupted");
+	}
+	if ((header.terrain_generator_id != save_signature.terrain_generator_id ||
+		header.seed != save_signature.seed) &&
+		not g_signature_mismatch_warned.test_and_set())
+	{
+		std::cout << "\x1b[33mWarning:\x1b[39m "
+			<< "Some saved chunks were generated with an other terrain generator or seed, "
+			<< "they may not match the chunks generated around them."
+			<< std::endl;
+	}
+
+	std::uint32_t palette_size;
+	if ((not read_varint(cursor, end, palette_size)) || palette_size == 0)
+	{
+		saved_chunk_error(chunk_coords, "its data is corrupted");
+	}
+	std::vector<Block> palette(palette_size);
+	for (Block& block : palette)
+	{
+		std::uint32_t type_id;
+		if (not read_varint(cursor, end, type_id))
+		{
+			saved_chunk_error(chunk_coords, "its data is corrupted");
+		}
+		block.type_id = type_id;
+	}
+	/* A chunk with only one block type is loaded as homogeneous, its runs (that are still
+	 * saved) are only checked. */
+	bool const is_homogeneous = palette_size == 1;
+	ChunkBField b_field = is_homogeneous ?
+		ChunkBField::homogeneous(chunk_coords, chunk_geometry, palette[0]) :
+		ChunkBField{chunk_coords, chunk_geometry};
+	Block* const blocks = is_homogeneous ? nullptr : b_field.raw_data();
+	unsigned int i = 0;
+	while (i < volume)
+	{
+		std::uint32_t run_length, palette_index;
+		if ((not read_varint(cursor, end, run_length)) ||
+			(not read_varint(cursor, end, palette_index)) ||
+			run_length > volume - i || palette_index >= palette_size)
+		{
+			saved_chunk_error(chunk_coords, "its data is corrupted");
+		}
+		if (not is_homogeneous)
+		{
+			std::fill(blocks + i, blocks + i + run_length, palette[palette_index]);
+		}
+		i += run_length;
+	}
+	if (cursor != end)
+	{
+		saved_chunk_error(chunk_coords, "its data is corrupted");
+	}
+	b_field.pack();
+	return b_field;
+}
+
+ChunkDiskStorage::ChunkDiskStorage(ChunkCoords chunk_coords):
+	chunk_coords(chunk_coords), modified(false)
+{
+	;
+}
+
+ChunkBField read_disk_chunk_b_field(ChunkCoords chunk_coords, ChunkGeometry chunk_geometry,
+	RegionFileTable& region_file_table, ChunkSaveSignature const& save_signature)
+{
+	std::optional<ChunkSavedData> const saved_data = region_file_table.read_chunk(chunk_coords);
+	if (not saved_data.has_value())
+	{
+		saved_chunk_error(chunk_coords, "its region file could not be read");
+	}
+	return deserialize_chunk_b_field(chunk_coords, chunk_geometry,
+		saved_data->data, saved_data->byte_size, save_signature);
+}
+
+ChunkSaveWriter::ChunkSaveWriter(RegionFileTable* region_file_table):
+	region_file_table{region_file_table},
+	thread_should_finish{false},
+	written_count{0}
+{
+	;
+}
+
+ChunkSaveWriter::~ChunkSaveWriter()
+{
+	if (not this->thread.joinable())
+	{
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock{this->mutex};
+		this->thread_should_finish = true;
+	}
+	this->work_condition_variable.notify_one();
+	this->thread.join();
+}
+
+void ChunkSaveWriter::start(ChunkSaveSignature save_signature)
+{
+	assert(not this->thread.joinable());
+	this->save_signature = save_signature;
+	this->thread = std::thread{&ChunkSaveWriter::thread_work, this};
+}
+
+bool ChunkSaveWriter::is_started() const
+{
+	return this->thread.joinable();
+}
+
+void ChunkSaveWriter::save(ChunkBField const& chunk_b_field)
+{
+	assert(this->is_started());
+
+	/* The thread gets a packed (or homogeneous) copy of the field, as packed values are never
+	 * modified in place (see `ChunkField::packed_values`), so that the chunk can be modified
+	 * while it is being written. A field that cannot be packed gets its own array instead. */
+	ChunkBField b_field_to_write = chunk_b_field;
+	b_field_to_write.pack();
+	if (not (b_field_to_write.is_homogeneous() || b_field_to_write.is_packed()))
+	{
+		ChunkBField const shared_b_field = b_field_to_write;
+		b_field_to_write = ChunkBField{chunk_b_field.chunk_coords, chunk_b_field.geometry};
+		std::memcpy(b_field_to_write.raw_data(), shared_b_field.raw_data(),
+			sizeof (Block) * chunk_b_field.geometry.volume());
+	}
+
+	ChunkCoords const chunk_coords = chunk_b_field.chunk_coords;
+	{
+		std::unique_lock<std::mutex> lock{this->mutex};
+		this->progress_condition_variable.wait(lock,
+			[this, chunk_coords]{
+				return this->waiting_table.size() < MAX_WAITING_COUNT ||
+					this->waiting_table.find(chunk_coords) != this->waiting_table.end();
+			});
+		this->waiting_table.insert_or_assign(chunk_coords, std::move(b_field_to_write));
+	}
+	this->work_condition_variable.notify_one();
+}
+
+bool ChunkSaveWriter::has_unwritten_b_field(ChunkCoords chunk_coords) const
+{
+	std::lock_guard<std::mutex> lock{this->mutex};
+	return this->waiting_table.find(chunk_coords) != this->waiting_table.end() ||
+		this->writing_table.find(chunk_coords) != this->writing_table.end();
+}
+
+std::optional<ChunkBField> ChunkSaveWriter::unwritten_b_field(ChunkCoords chunk_coords) const
+{
+	std::lock_guard<std::mutex> lock{this->mutex};
+	/* The waiting B field is more recent than the one being written, if both are there. */
+	auto const waiting_iterator = this->waiting_table.find(chunk_coords);
+	if (waiting_iterator != this->waiting_table.end())
+	{
+		return waiting_iterator->second;
+	}
+	auto const writing_iterator = this->writing_table.find(chunk_coords);
+	if (writing_iterator != this->writing_table.end())
+	{
+		return writing_iterator->second;
+	}
+	return std::nullopt;
+}
+
+unsigned int ChunkSaveWriter::unwritten_count() const
+{
+	std::lock_guard<std::mutex> lock{this->mutex};
+	return this->waiting_table.size() + this->writing_table.size();
+}
+
+unsigned int ChunkSaveWriter::total_written_count() const
+{
+	std::lock_guard<std::mutex> lock{this->mutex};
+	return this->written_count;
+}
+
+bool ChunkSaveWriter::wait_until_all_written(std::chrono::milliseconds timeout)
+{
+	std::unique_lock<std::mutex> lock{this->mutex};
+	return this->progress_condition_variable.wait_for(lock, timeout,
+		[this]{
+			return this->waiting_table.empty() && this->writing_table.empty();
+		});
+}
+
+void ChunkSaveWriter::thread_work()
+{
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock{this->mutex};
+			this->work_condition_variable.wait(lock,
+				[this]{
+					return (not this->waiting_table.empty()) || this->thread_should_finish;
+				});
+			if (this->waiting_table.empty())
+			{
+				/* Finishing only once everything is written. */
+				return;
+			}
+			std::swap(this->waiting_table, this->writing_table);
+		}
+		this->progress_condition_variable.notify_all();
+
+		/* The chunks of a region are written together, in the order they have in the file. */
+		std::vector<ChunkCoords> chunk_coords_table;
+		chunk_coords_table.reserve(this->writing_table.size());
+		for (auto const& [chunk_coords, b_field] : this->writing_table)
+		{
+			chunk_coords_table.push_back(chunk_coords);
+		}
+		std::sort(chunk_coords_table.begin(), chunk_coords_table.end(),
+			[](ChunkCoords left, ChunkCoords right){
+				ChunkCoords const left_region = RegionFileTable::region_coords(left);
+				ChunkCoords const right_region = RegionFileTable::region_coords(right);
+				return
+					std::make_tuple(left_region.x, left_region.y, left_region.z,
+						RegionFileTable::chunk_index(left)) <
+					std::make_tuple(right_region.x, right_region.y, right_region.z,
+						RegionFileTable::chunk_index(right));
+			});
+
+		/* The writing table is only modified by this thread, so it can be read without
+		 * locking (the other threads only read it). */
+		for (ChunkCoords chunk_coords : chunk_coords_table)
+		{
+			std::vector<char> const data = serialize_chunk_b_field(
+				this->writing_table.at(chunk_coords), this->save_signature);
+			this->region_file_table->write_chunk(chunk_coords, data.data(), data.size());
+		}
+		this->region_file_table->flush();
+
+		{
+			std::lock_guard<std::mutex> lock{this->mutex};
+			this->written_count += this->writing_table.size();
+			this->writing_table.clear();
+		}
+		this->progress_condition_variable.notify_all();
+	}
+}
+
+ChunkGrid::ChunkGrid(ChunkGeometry geometry, std::string_view chunk_save_directory):
+	geometry{geometry},
+	chunk_save_directory{chunk_save_directory},
+	region_file_table{chunk_save_directory},
+	save_signature{geometry, std::string_view{}, 0},
+	save_writer{&this->region_file_table},
+	save_only_modified{true},
+	padded_neighborhoods{true},
+	greedy_meshing{false}
+{
+	;
+}
+
+void ChunkGrid::use_ring_buffer(unsigned int ring_side)
+{
+	this->ptg_field.use_ring_buffer(ring_side);
+	this->ptt_field.use_ring_buffer(ring_side);
+	this->b_field.use_ring_buffer(ring_side);
+	this->mesh.use_ring_buffer(ring_side);
+	this->mesh_block_table.use_ring_buffer(ring_side);
+	this->entity_table.use_ring_buffer(ring_side);
+	this->disk.use_ring_buffer(ring_side);
+	this->remesh_request.use_ring_buffer(ring_side);
+}
+
+bool ChunkGrid::has_ptg_field(ChunkCoords chunk_coords) const
+{
+	return this->ptg_field.find(chunk_coords) != this->ptg_field.end();
+}
+
+bool ChunkGrid::has_ptt_field(ChunkCoords chunk_coords) const
+{
+	return this->ptt_field.find(chunk_coords) != this->ptt_field.end();
+}
+
+bool ChunkGrid::has_b_field(ChunkCoords chunk_coords) const
+{
+	return this->b_field.find(chunk_coords) != this->b_field.end();
+}
+
+bool ChunkGrid::has_complete_mesh(ChunkCoords chunk_coords) const
+{
+	return this->mesh.find(chunk_coords) != this->mesh.end();
+}
+
+bool ChunkGrid::has_entity_table(ChunkCoords chunk_coords) const
+{
+	return this->entity_table.find(chunk_coords) != this->entity_table.end();
+}
+
+bool ChunkGrid::has_disk_storage(ChunkCoords chunk_coords) const
+{
+	return this->disk.find(chunk_coords) != this->disk.end();
+}
+
+bool ChunkGrid::has_saved_b_field(ChunkCoords chunk_coords) const
+{
+	/* The writer is asked first, as a B field that it writes is in the region files
+	 * before it stops being unwritten. */
+	return this->save_writer.has_unwritten_b_field(chunk_coords) ||
+		this->region_file_table.has_chunk(chunk_coords);
+}
+
+bool ChunkGrid::has_ptg_field_neighborhood(ChunkCoords center_chunk_coords) const
+{
+	for (int dx = -1; dx <= 1; dx++)
+	for (int dy = -1; dy <= 1; dy++)
+	for (int dz = -1; dz <= 1; dz++)
+	{
+		ChunkCoords const chunk_coords = center_chunk_coords + ChunkCoords{dx, dy, dz};
+		auto iterator = this->ptg_field.find(chunk_coords);
+		if (iterator == this->ptg_field.end())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool ChunkGrid::has_ptt_field_neighborhood(ChunkCoords center_chunk_coords) const
+{
+	for (int dx = -1; dx <= 1; dx++)
+	for (int dy = -1; dy <= 1; dy++)
+	for (int dz = -1; dz <= 1; dz++)
+	{
+		ChunkCoords const chunk_coords = center_chunk_coords + ChunkCoords{dx, dy, dz};
+		auto iterator = this->ptt_field.find(chunk_coords);
+		if (iterator == this->ptt_field.end())
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool ChunkGrid::has_b_field_neighborhood(ChunkCoords center_chunk_coords) const
+{
+	for (int dx = -1; dx <= 1; dx++)
 	for (int dy = -1; dy <= 1; dy++)
 	for (int dz = -1; dz <= 1; dz++)
 	{
@@ -709,179 +2122,604 @@ ChunkNeighborhood<ChunkPttField> const
 	return ptt_field_neighborhood;
 }
 
-ChunkNeighborhood<ChunkBField> const
-	ChunkGrid::get_b_field_neighborhood(ChunkCoords center_chunk_coords) const
+ChunkNeighborhood<ChunkBField> const
+	ChunkGrid::get_b_field_neighborhood(ChunkCoords center_chunk_coords) const
+{
+	ChunkNeighborhood<ChunkBField> b_field_neighborhood;
+	for (int dx = -1; dx <= 1; dx++)
+	for (int dy = -1; dy <= 1; dy++)
+	for (int dz = -1; dz <= 1; dz++)
+	{
+		ChunkCoords const chunk_coords = center_chunk_coords + ChunkCoords{dx, dy, dz};
+		auto iterator = this->b_field.find(chunk_coords);
+		assert(iterator != this->b_field.end());
+		ChunkCoords const local_coords = ChunkCoords{dx + 1, dy + 1, dz + 1};
+		unsigned int const index = local_coords.x + local_coords.y * 3 + local_coords.z * 3 * 3;
+		b_field_neighborhood.field_table[index] = iterator->second;
+	}
+	return b_field_neighborhood;
+}
+
+bool ChunkGrid::block_is_air_or_unloaded(BlockCoords coords) const
+{
+	ChunkCoords const chunk_coords = this->geometry.containing_chunk_coords(coords);
+	auto iterator = this->b_field.find(chunk_coords);
+	if (iterator != this->b_field.end())
+	{
+		return iterator->second[coords].is_air();
+	}
+	else
+	{
+		return true;
+	}
+}
+
+void ChunkGrid::set_block(BlockCoords coords, BlockTypeId new_type_id)
+{
+	ChunkCoords const chunk_coords = this->geometry.containing_chunk_coords(coords);
+
+	/* Modify the B field (the actual blocks). */
+	ChunkBField& b_field = this->b_field.at(chunk_coords);
+	b_field.set(coords, Block{new_type_id});
+
+	/* Update the meshes.
+	 * Due to concerns such as ambiant occlusion, nearby chunks may
+	 * also have to also be remeshed. */
+	BlockRect const concerned_blocks{coords, 2};
+	ChunkRect const concerned_chunks =
+		this->geometry.containing_chunk_rect(concerned_blocks);
+	for (ChunkCoords const chunk_coords : concerned_chunks)
+	{
+		if (not this->has_complete_mesh(chunk_coords))
+		{
+			/* Its mesh is yet to be generated, but it may already be generated from a copy of
+			 * the B fields from before the modification (the modified field gets new values
+			 * instead of modifying the shared ones, see `ChunkField::set`), so a remeshing is
+			 * requested anyway, to be done once the mesh lands. */
+			this->remesh_request.emplace(chunk_coords, std::chrono::high_resolution_clock::now());
+			continue;
+		}
+
+		auto const block_table_iterator = this->mesh_block_table.find(chunk_coords);
+		if ((not this->greedy_meshing) && block_table_iterator != this->mesh_block_table.end())
+		{
+			/* Only the concerned blocks that are in this chunk are remeshed in place,
+			 * which is cheap enough to be done right now. */
+			Mesh<VertexDataChunk>& mesh = this->mesh.at(chunk_coords);
+			ChunkNeighborhood<ChunkBField> const chunk_neighborhood_b_field =
+				this->get_b_field_neighborhood(chunk_coords);
+			for (BlockCoords const block_coords : concerned_blocks)
+			{
+				if (this->geometry.containing_chunk_coords(block_coords) == chunk_coords)
+				{
+					remesh_block_in_chunk_mesh(block_coords, chunk_coords, this->geometry,
+						chunk_neighborhood_b_field, block_table_iterator->second, mesh);
+				}
+			}
+		}
+		else
+		{
+			/* The chunk is to be completely remeshed (and to get a block table without greedy
+			 * meshing, so that the next modifications can be done in place).
+			 * Requesting a remeshing that is already requested keeps the oldest time. */
+			this->remesh_request.emplace(chunk_coords, std::chrono::high_resolution_clock::now());
+		}
+	}
+
+	/* Mark the chunk as modified, which makes sure it will be saved to the disk (if required). */
+	if (not this->has_disk_storage(chunk_coords))
+	{
+		this->disk.insert(std::make_pair(chunk_coords, ChunkDiskStorage{chunk_coords}));
+	}
+	ChunkDiskStorage& chunk_disk_storage = this->disk.at(chunk_coords);
+	chunk_disk_storage.modified = true;
+}
+
+void ChunkGrid::add_entity(Entity* entity)
+{
+	BlockCoords coords{entity->coords};
+	ChunkCoords chunk_coords = this->geometry.containing_chunk_coords(coords);
+	if (not this->has_entity_table(chunk_coords))
+	{
+		this->entity_table.insert(std::make_pair(chunk_coords, ChunkEntityTable{}));
+	}
+	ChunkEntityTable& chunk_entity_table = this->entity_table.at(chunk_coords);
+	
+	for (Entity*& entry : chunk_entity_table.entities)
+	{
+		if (entry == nullptr)
+		{
+			entry = entity;
+			return;
+		}
+	}
+	chunk_entity_table.entities.push_back(entity);
+}
+
+void ChunkGrid::unload(ChunkCoords chunk_coords)
+{
+	std::cout << "Unload chunk " << chunk_coords << std::endl;
+	this->unload_ptg_field(chunk_coords);
+	this->unload_ptt_field(chunk_coords);
+	if (this->has_b_field(chunk_coords))
+	{
+		this->save_b_field_if_necessary(chunk_coords);
+		this->b_field.erase(chunk_coords);
+	}
+	if (this->has_complete_mesh(chunk_coords))
+	{
+		/* The destruction of the OpenGL buffer and the freeing of the CPU-side buffer
+		 * is done in the `Mesh` destructor. */
+		this->mesh.erase(this->mesh.find(chunk_coords));
+	}
+	this->mesh_block_table.erase(chunk_coords);
+	this->remesh_request.erase(chunk_coords);
+	if (this->has_disk_storage(chunk_coords))
+	{
+		this->disk.erase(this->disk.find(chunk_coords));
+	}
+}
+
+void ChunkGrid::unload_ptg_field(ChunkCoords chunk_coords)
+{
+	this->ptg_field.erase(chunk_coords);
+}
+
+void ChunkGrid::unload_ptt_field(ChunkCoords chunk_coords)
+{
+	this->ptt_field.erase(chunk_coords);
+}
+
+void ChunkGrid::save_b_field_if_necessary(ChunkCoords chunk_coords)
+{
+	if (not this->save_writer.is_started())
+	{
+		/* Saving is disabled. */
+		return;
+	}
+	if (not this->has_disk_storage(chunk_coords))
+	{
+		this->disk.insert(std::make_pair(chunk_coords, ChunkDiskStorage{chunk_coords}));
+	}
+	ChunkDiskStorage& chunk_disk_storage = this->disk.at(chunk_coords);
+
+	if (chunk_disk_storage.modified ||
+		(not this->save_only_modified))
+	{
+		if (this->has_b_field(chunk_coords))
+		{
+			this->save_writer.save(this->b_field.at(chunk_coords));
+			chunk_disk_storage.modified = false;
+		}
+	}
+}
+
+void ChunkGrid::save_all_that_is_necessary()
+{
+	for (auto& [chunk_coords, b_field] : this->b_field)
+	{
+		this->save_b_field_if_necessary(chunk_coords);
+	}
+}
+
+namespace
+{
+
+/* Completely remeshes a chunk after some of its blocks were modified. */
+ChunkRemeshResult remesh_chunk(
+	ChunkCoords chunk_coords,
+	ChunkGeometry chunk_geometry,
+	ChunkNeighborhood<ChunkBField> const chunk_neighborhood_b_field,
+	bool padded_neighborhoods,
+	bool greedy_meshing,
+	Nature const& nature)
+{
+	if (greedy_meshing)
+	{
+		if (padded_neighborhoods &&
+			not chunk_mesh_is_trivially_empty(chunk_neighborhood_b_field))
+		{
+			PaddedChunkNeighborhoodBField const
+				padded_neighborhood_b_field{chunk_neighborhood_b_field};
+			return ChunkRemeshResult{generate_chunk_complete_mesh(chunk_coords, chunk_geometry,
+				padded_neighborhood_b_field, nature, true), std::nullopt};
+		}
+		return ChunkRemeshResult{generate_chunk_complete_mesh(chunk_coords, chunk_geometry,
+			chunk_neighborhood_b_field, nature, true), std::nullopt};
+	}
+	ChunkMeshBlockTable block_table{chunk_geometry};
+	ChunkMeshData* mesh_data = generate_chunk_complete_mesh_and_block_table(
+		chunk_coords, chunk_geometry, chunk_neighborhood_b_field, nature, block_table);
+	return ChunkRemeshResult{mesh_data, std::move(block_table)};
+}
+
+/* The priority levels of the tasks given to the thread pool by the chunk generation manager.
+ * The remeshings requested by block modifications are the most urgent, then come the generation
+ * steps that are the closest to giving a chunk its mesh. */
+unsigned int constexpr REMESH_PRIORITY_LEVEL = 5;
+unsigned int chunk_generating_step_priority_level(ChunkGeneratingStep step)
+{
+	switch (step)
+	{
+		case ChunkGeneratingStep::MESH:
+			return 4;
+		case ChunkGeneratingStep::DISK_READ_B_FIELD:
+		case ChunkGeneratingStep::GENERATE_B_FIELD:
+			return 3;
+		case ChunkGeneratingStep::GENERATE_PTT_FIELD:
+			return 2;
+		case ChunkGeneratingStep::GENERATE_PTG_FIELD:
+			return 1;
+		default:
+			return 0;
+	}
+}
+
+int squared_length(ChunkCoords offset)
+{
+	return offset.x * offset.x + offset.y * offset.y + offset.z * offset.z;
+}
+
+/* The normalized motion of the player, or zero if the player is not really moving. */
+glm::vec3 motion_direction(glm::vec3 motion)
+{
+	float const length = glm::length(motion);
+	return length < 0.05f ? glm::vec3{0.0f, 0.0f, 0.0f} : motion / length;
+}
+
+bool is_falling_down(bool is_falling, glm::vec3 motion)
+{
+	return is_falling && motion.z < 0.0f;
+}
+
+} /* Anonymous namespace. */
+
+ChunkGenerationPriorityWeights::ChunkGenerationPriorityWeights():
+	view{0.0f}, motion{0.0f}, falling{0.0f}
+{
+	;
+}
+
+bool ChunkGenerationPriorityWeights::are_all_zero() const
+{
+	return this->view == 0.0f && this->motion == 0.0f && this->falling == 0.0f;
+}
+
+bool ChunkGeneratingData::operator==(ChunkGeneratingData const& other) const
+{
+	return this->chunk_coords == other.chunk_coords && this->step == other.step;
+}
+
+std::size_t ChunkGeneratingData::Hash::operator()(
+	ChunkGeneratingData const& generating_data) const noexcept
 {
-	ChunkNeighborhood<ChunkBField> b_field_neighborhood;
-	for (int dx = -1; dx <= 1; dx++)
-	for (int dy = -1; dy <= 1; dy++)
-	for (int dz = -1; dz <= 1; dz++)
-	{
-		ChunkCoords const chunk_coords = center_chunk_coords + ChunkCoords{dx, dy, dz};
-		auto iterator = this->b_field.find(chunk_coords);
-		assert(iterator != this->b_field.end());
-		ChunkCoords const local_coords = ChunkCoords{dx + 1, dy + 1, dz + 1};
-		unsigned int const index = local_coords.x + local_coords.y * 3 + local_coords.z * 3 * 3;
-		b_field_neighborhood.field_table[index] = iterator->second;
-	}
-	return b_field_neighborhood;
+	return ChunkCoords::Hash{}(generating_data.chunk_coords) * 31 +
+		static_cast<std::size_t>(generating_data.step);
 }
 
-bool ChunkGrid::block_is_air_or_unloaded(BlockCoords coords) const
+void ChunkGenerationCompletionQueue::push(ChunkGeneratedData&& generated_data)
 {
-	ChunkCoords const chunk_coords = containing_chunk_coords(coords);
-	auto iterator = this->b_field.find(chunk_coords);
-	if (iterator != this->b_field.end())
-	{
-		return iterator->second[coords].is_air();
-	}
-	else
+	std::lock_guard<std::mutex> lock{this->mutex};
+	this->generated_data_vector.push_back(std::move(generated_data));
+}
+
+std::vector<ChunkGeneratedData> ChunkGenerationCompletionQueue::take_all()
+{
+	std::vector<ChunkGeneratedData> generated_data_vector;
 	{
-		return true;
+		std::lock_guard<std::mutex> lock{this->mutex};
+		std::swap(generated_data_vector, this->generated_data_vector);
 	}
+	return generated_data_vector;
 }
 
-void ChunkGrid::set_block(Nature const* nature,
-	BlockCoords coords, BlockTypeId new_type_id)
+ChunkGenerationManager::ChunkGenerationManager():
+	thread_pool{nullptr},
+	chunk_grid{nullptr},
+	generation_center{0.0f, 0.0f, 0.0f},
+	generation_radius{50.0f},
+	generation_enabled{true},
+	generation_offset_table_radius{-1.0f},
+	view_direction{1.0f, 0.0f, 0.0f},
+	view_half_angle{1.0f},
+	player_motion{0.0f, 0.0f, 0.0f},
+	player_is_falling{false},
+	ordered_view_direction{1.0f, 0.0f, 0.0f},
+	ordered_motion_direction{0.0f, 0.0f, 0.0f},
+	ordered_falling{false},
+	first_not_generated_offset_index{0},
+	generating_data_cap{4},
+	completion_queue{std::make_shared<ChunkGenerationCompletionQueue>()},
+	frame{0}
 {
-	ChunkCoords const chunk_coords = containing_chunk_coords(coords);
+	;
+}
 
-	/* Modify the B field (the actual blocks). */
-	ChunkBField& b_field = this->b_field.at(chunk_coords);
-	b_field[coords].type_id = new_type_id;
+void ChunkGenerationManager::manage_remeshing(Nature const& nature)
+{
+	using clock = std::chrono::high_resolution_clock;
+	this->last_remesh_latency.reset();
 
-	/* Update the meshes.
-	 * Due to concerns such as ambiant occlusion, nearby chunks may
-	 * also have to also be remeshed. */
-	BlockRect const concerned_blocks{coords, 2};
-	ChunkRect const concerned_chunks =
-		containing_chunk_rect(concerned_blocks);
-	for (ChunkCoords const chunk_coords : concerned_chunks)
+	/* Take the new requests. */
+	for (auto const& [chunk_coords, edit_time] : this->chunk_grid->remesh_request)
 	{
-		/* TODO: Make the remeshing in other threads with highest priority or something.
-		 * Without this, when the remeshing happens to take too long (it happens sometimes)
-		 * it blocks the main thread and the game freezes for a bit. */
-		
-		Mesh<VertexDataClassic>& mesh =
-			this->mesh.at(chunk_coords);
-		ChunkMeshData* data = generate_chunk_complete_mesh(chunk_coords,
-			this->get_b_field_neighborhood(chunk_coords),
-			*nature);
-		mesh.vertex_data = std::move(*data);
-		mesh.needs_update_opengl_data = true;
+		/* If a remeshing of the chunk is already waiting then it will take these
+		 * modifications into account, and its modifications are older. */
+		this->waiting_remeshing_data.emplace(chunk_coords,
+			ChunkRemeshingData{edit_time, this->frame, {}});
 	}
+	this->chunk_grid->remesh_request.clear();
 
-	/* Mark the chunk as modified, which makes sure it will be saved to the disk (if required). */
-	if (not this->has_disk_storage(chunk_coords))
+	/* Land the finished remeshings, the old meshes were still rendered until now. */
+	for (auto it = this->remeshing_data.begin(); it != this->remeshing_data.end();)
 	{
-		this->disk.insert(std::make_pair(chunk_coords, ChunkDiskStorage{chunk_coords}));
-	}
-	ChunkDiskStorage& chunk_disk_storage = this->disk.at(chunk_coords);
-	chunk_disk_storage.modified = true;
-}
+		using namespace std::chrono_literals;
+		auto& [chunk_coords, remeshing_data] = *it;
+		if (remeshing_data.future.wait_for(0s) != std::future_status::ready)
+		{
+			++it;
+			continue;
+		}
+		ChunkRemeshResult result = remeshing_data.future.get();
+		if (this->chunk_grid->has_complete_mesh(chunk_coords))
+		{
+			Mesh<VertexDataChunk>& mesh = this->chunk_grid->mesh.at(chunk_coords);
+			mesh.vertex_data = std::move(*result.mesh_data);
+			mesh.dirty_vertex_range.reset();
+			mesh.needs_update_opengl_data = true;
+
+			/* If some blocks were modified since the remeshing started, then the block table
+			 * is not used as an other remeshing will soon replace this mesh. */
+			bool const is_up_to_date =
+				this->waiting_remeshing_data.find(chunk_coords) ==
+					this->waiting_remeshing_data.end();
+			if (result.block_table.has_value() && is_up_to_date)
+			{
+				this->chunk_grid->mesh_block_table.insert_or_assign(chunk_coords,
+					std::move(result.block_table.value()));
+			}
+			else
+			{
+				this->chunk_grid->mesh_block_table.erase(chunk_coords);
+			}
 
-void ChunkGrid::add_entity(Entity* entity)
-{
-	BlockCoords coords{entity->coords};
-	ChunkCoords chunk_coords = containing_chunk_coords(coords);
-	if (not this->has_entity_table(chunk_coords))
-	{
-		this->entity_table.insert(std::make_pair(chunk_coords, ChunkEntityTable{}));
+			ChunkRemeshLatency const latency{
+				this->frame - remeshing_data.edit_frame,
+				std::chrono::duration<float, std::milli>(
+					clock::now() - remeshing_data.edit_time).count()};
+			if ((not this->last_remesh_latency.has_value())
+				|| this->last_remesh_latency->milliseconds < latency.milliseconds)
+			{
+				this->last_remesh_latency = latency;
+			}
+		}
+		delete result.mesh_data;
+		it = this->remeshing_data.erase(it);
 	}
-	ChunkEntityTable& chunk_entity_table = this->entity_table.at(chunk_coords);
-	
-	for (Entity*& entry : chunk_entity_table.entities)
+
+	/* Start the waiting remeshings, unless their chunk is still being remeshed or does not
+	 * have what it takes yet (its mesh may still be being generated, or some of its neighbors
+	 * may not have their B field yet), in which case they keep waiting. The remeshings of
+	 * chunks that have no B field are dropped (the chunk was unloaded, or its mesh cannot
+	 * have been generated yet and will be from the modified blocks). */
+	for (auto it = this->waiting_remeshing_data.begin();
+		it != this->waiting_remeshing_data.end();)
 	{
-		if (entry == nullptr)
+		auto& [chunk_coords, remeshing_data] = *it;
+		if (not this->chunk_grid->has_b_field(chunk_coords))
 		{
-			entry = entity;
-			return;
+			it = this->waiting_remeshing_data.erase(it);
+			continue;
 		}
+		if (this->remeshing_data.find(chunk_coords) != this->remeshing_data.end()
+			|| (not this->chunk_grid->has_complete_mesh(chunk_coords))
+			|| (not this->chunk_grid->has_b_field_neighborhood(chunk_coords)))
+		{
+			++it;
+			continue;
+		}
+		float const distance = glm::distance(
+			static_cast<glm::vec3>(this->chunk_grid->geometry.center_coords(chunk_coords)),
+			this->generation_center);
+		remeshing_data.future = this->thread_pool->give_task(std::bind(
+			remesh_chunk,
+			chunk_coords,
+			this->chunk_grid->geometry,
+			this->chunk_grid->get_b_field_neighborhood(chunk_coords),
+			this->chunk_grid->padded_neighborhoods,
+			this->chunk_grid->greedy_meshing,
+			std::cref(nature)), TaskPriority{REMESH_PRIORITY_LEVEL, distance});
+		this->remeshing_data.insert(std::make_pair(chunk_coords, std::move(remeshing_data)));
+		it = this->waiting_remeshing_data.erase(it);
 	}
-	chunk_entity_table.entities.push_back(entity);
 }
 
-void ChunkGrid::unload(ChunkCoords chunk_coords)
+void ChunkGenerationManager::update_generation_offset_table()
 {
-	std::cout << "Unload chunk " << chunk_coords << std::endl;
-	if (this->has_ptg_field(chunk_coords))
-	{
-		auto it = this->ptg_field.find(chunk_coords);
-		it->second.free_data();
-		this->ptg_field.erase(it);
-	}
-	if (this->has_ptt_field(chunk_coords))
+	ChunkGeometry const chunk_geometry = this->chunk_grid->geometry;
+	int const chunk_generation_radius = 1 + static_cast<int>(
+		this->generation_radius / static_cast<float>(chunk_geometry.side));
+	/* Squared distance (in chunks) to the generation center above which chunks are too far.
+	 * The condition leaves a little room for chunks too far to get generated anyway,
+	 * but it does not matter that much. */
+	float const max_distance =
+		(this->generation_radius + chunk_geometry.side) / static_cast<float>(chunk_geometry.side);
+	float const max_squared_distance = max_distance * max_distance;
+
+	this->generation_offset_table.clear();
+	for (ChunkCoords const offset :
+		ChunkRect{ChunkCoords{0, 0, 0}, static_cast<unsigned int>(chunk_generation_radius)})
 	{
-		auto it = this->ptt_field.find(chunk_coords);
-		it->second.free_data();
-		this->ptt_field.erase(it);
+		if (static_cast<float>(squared_length(offset)) <= max_squared_distance)
+		{
+			this->generation_offset_table.push_back(offset);
+		}
 	}
-	if (this->has_b_field(chunk_coords))
+	std::stable_sort(
+		this->generation_offset_table.begin(), this->generation_offset_table.end(),
+		[](ChunkCoords const& left, ChunkCoords const& right){
+			return squared_length(left) < squared_length(right);
+		});
+
+	this->generation_offset_table_radius = this->generation_radius;
+	this->order_generation_offset_table();
+}
+
+void ChunkGenerationManager::order_generation_offset_table()
+{
+	this->ordered_view_direction = this->view_direction;
+	this->ordered_motion_direction = motion_direction(this->player_motion);
+	this->ordered_falling = is_falling_down(this->player_is_falling, this->player_motion);
+	this->first_not_generated_offset_index = 0;
+	if (this->priority_weights.are_all_zero())
 	{
-		this->save_b_field_if_necessary(chunk_coords);
-		auto it = this->b_field.find(chunk_coords);
-		it->second.free_data();
-		this->b_field.erase(it);
+		/* The table is already ordered by distance. */
+		return;
 	}
-	if (this->has_complete_mesh(chunk_coords))
+
+	auto const priority_distance = [this](ChunkCoords offset){
+		float const length = std::sqrt(static_cast<float>(squared_length(offset)));
+		if (length == 0.0f)
+		{
+			return 0.0f;
+		}
+		glm::vec3 const offset_direction = static_cast<glm::vec3>(offset) / length;
+		float factor = 1.0f;
+		if (this->offset_is_in_view(offset, this->ordered_view_direction))
+		{
+			factor += this->priority_weights.view;
+		}
+		factor += this->priority_weights.motion *
+			std::max(0.0f, glm::dot(offset_direction, this->ordered_motion_direction));
+		if (this->ordered_falling
+			&& offset.z < 0 && std::abs(offset.x) <= 1 && std::abs(offset.y) <= 1)
+		{
+			factor += this->priority_weights.falling;
+		}
+		return length / factor;
+	};
+	std::vector<std::pair<float, ChunkCoords>> ordered_table;
+	ordered_table.reserve(this->generation_offset_table.size());
+	for (ChunkCoords const offset : this->generation_offset_table)
 	{
-		/* The destruction of the OpenGL buffer and the freeing of the CPU-side buffer
-		 * is done in the `Mesh` destructor. */
-		this->mesh.erase(this->mesh.find(chunk_coords));
+		ordered_table.push_back(std::make_pair(priority_distance(offset), offset));
 	}
-	if (this->has_disk_storage(chunk_coords))
+	std::sort(ordered_table.begin(), ordered_table.end(),
+		[](std::pair<float, ChunkCoords> const& left, std::pair<float, ChunkCoords> const& right){
+			if (left.first != right.first)
+			{
+				return left.first < right.first;
+			}
+			return squared_length(left.second) < squared_length(right.second);
+		});
+	for (unsigned int i = 0; i < ordered_table.size(); i++)
 	{
-		this->disk.erase(this->disk.find(chunk_coords));
+		this->generation_offset_table[i] = ordered_table[i].second;
 	}
 }
 
-void ChunkGrid::save_b_field_if_necessary(ChunkCoords chunk_coords)
+bool ChunkGenerationManager::generation_offset_table_needs_reordering() const
 {
-	if (not this->has_disk_storage(chunk_coords))
+	if (this->priority_weights.view != 0.0f
+		&& glm::dot(this->view_direction, this->ordered_view_direction) < 0.985f)
 	{
-		this->disk.insert(std::make_pair(chunk_coords,ChunkDiskStorage{chunk_coords}));
+		/* The view turned by more than about 10 degrees. */
+		return true;
 	}
-	ChunkDiskStorage& chunk_disk_storage = this->disk.at(chunk_coords);
-
-	if (chunk_disk_storage.modified ||
-		(not g_game->chunk_generation_manager.save_only_modified))
+	if (this->priority_weights.motion != 0.0f)
 	{
-		if (this->has_b_field(chunk_coords))
+		glm::vec3 const current_motion_direction = motion_direction(this->player_motion);
+		bool const is_moving = glm::length(current_motion_direction) != 0.0f;
+		bool const was_moving = glm::length(this->ordered_motion_direction) != 0.0f;
+		if (is_moving != was_moving
+			|| (is_moving &&
+				glm::dot(current_motion_direction, this->ordered_motion_direction) < 0.94f))
 		{
-			ChunkBField& b_field = this->b_field.at(chunk_coords);
-			write_disk_chunk_b_field(chunk_coords, chunk_disk_storage, b_field);
+			/* The motion started, stopped or turned by more than about 20 degrees. */
+			return true;
 		}
 	}
+	if (this->priority_weights.falling != 0.0f
+		&& is_falling_down(this->player_is_falling, this->player_motion) != this->ordered_falling)
+	{
+		return true;
+	}
+	return false;
 }
 
-void ChunkGrid::save_all_that_is_necessary()
+bool ChunkGenerationManager::offset_is_in_view(ChunkCoords offset, glm::vec3 view_direction) const
 {
-	for (auto& [chunk_coords, b_field] : this->b_field)
+	float const length = std::sqrt(static_cast<float>(squared_length(offset)));
+	if (length == 0.0f)
 	{
-		this->save_b_field_if_necessary(chunk_coords);
+		return true;
 	}
+	float const cos_angle = glm::dot(static_cast<glm::vec3>(offset) / length, view_direction);
+	float const angle = std::acos(std::clamp(cos_angle, -1.0f, 1.0f));
+	/* A chunk is in view if any part of it is, so the angle it covers
+	 * (as seen from the center of the chunk containing the generation center) is added. */
+	float const chunk_angular_radius = std::atan(0.87f / length);
+	return angle <= this->view_half_angle + chunk_angular_radius;
 }
 
-ChunkGenerationManager::ChunkGenerationManager():
-	thread_pool{nullptr},
-	chunk_grid{nullptr},
-	generation_center{0.0f, 0.0f, 0.0f},
-	generation_radius{50.0f},
-	generation_enabled{true}
+void ChunkGenerationManager::update_view_metrics(ChunkCoords chunk_generation_center,
+	std::vector<ChunkCoords> const& landed_mesh_chunk_coords_table)
 {
-	;
+	using clock = std::chrono::high_resolution_clock;
+	ChunkGenerationViewMetrics& metrics = this->view_metrics;
+	if (metrics.time_to_fill_view.has_value())
+	{
+		return;
+	}
+	float const time =
+		std::chrono::duration<float>(clock::now() - metrics.start_time).count();
+
+	if (not metrics.time_to_first_visible_ground.has_value())
+	{
+		for (ChunkCoords const chunk_coords : landed_mesh_chunk_coords_table)
+		{
+			if (this->chunk_grid->has_complete_mesh(chunk_coords)
+				&& not this->chunk_grid->mesh.at(chunk_coords).vertex_data.empty()
+				&& this->offset_is_in_view(
+					chunk_coords - chunk_generation_center, this->view_direction))
+			{
+				metrics.time_to_first_visible_ground = time;
+				break;
+			}
+		}
+	}
+
+	for (ChunkCoords const offset : this->generation_offset_table)
+	{
+		if (this->offset_is_in_view(offset, this->view_direction)
+			&& not this->chunk_grid->has_complete_mesh(chunk_generation_center + offset))
+		{
+			return;
+		}
+	}
+	metrics.time_to_fill_view = time;
+	if (metrics.is_since_spawn)
+	{
+		std::cout << "[Generation] "
+			<< "View filled " << time << " seconds after spawning";
+		if (metrics.time_to_first_visible_ground.has_value())
+		{
+			std::cout << " (first visible ground after "
+				<< metrics.time_to_first_visible_ground.value() << " seconds)";
+		}
+		std::cout << "." << std::endl;
+	}
 }
 
-void ChunkGenerationManager::manage(Nature const& nature)
+void ChunkGenerationManager::unload_far_chunks()
 {
-	/* Priority to unloading chunks that are too far.
-	 * It seems fast enough for now that it can be done in the main thread. */
 	std::vector<ChunkCoords> chunks_to_unload;
 	auto consider_unloading = [this, &chunks_to_unload](ChunkCoords chunk_coords){
-		BlockCoords center_coords = chunk_center_coords(chunk_coords);
+		BlockCoords center_coords = this->chunk_grid->geometry.center_coords(chunk_coords);
 		float dist = glm::distance(
 			static_cast<glm::vec3>(center_coords), this->generation_center);
-		dist += g_game->chunk_side; /* Just to be sure the chunk is completely out. */
+		/* Just to be sure the chunk is completely out. */
+		dist += this->chunk_grid->geometry.side;
 		if (this->generation_radius + this->unloading_margin < dist)
 		{
 			chunks_to_unload.push_back(chunk_coords);
@@ -892,323 +2730,415 @@ void ChunkGenerationManager::manage(Nature const& nature)
 	{
 		consider_unloading(chunk_coords);
 	}
-	/* Should cover chunks that have a PTG field and chunks that have a PTT field. */
+	/* Should cover chunks that have a PTG field and chunks that have a PTT field
+	 * (the PTG field may have been unloaded before the PTT field). */
 	for (auto& [chunk_coords, field] : this->chunk_grid->ptg_field)
 	{
 		consider_unloading(chunk_coords);
 	}
-	/* Unloading a chunk invalidates iterators on the affected `std::unsorted_map`s,
+	for (auto& [chunk_coords, field] : this->chunk_grid->ptt_field)
+	{
+		if (not this->chunk_grid->has_ptg_field(chunk_coords))
+		{
+			consider_unloading(chunk_coords);
+		}
+	}
+	/* Unloading a chunk erases entries from the component grids that are iterated over above,
 	 * thus instead we iterate over a vector of chunk coordinates. */
 	for (ChunkCoords chunk_coords : chunks_to_unload)
 	{
 		this->chunk_grid->unload(chunk_coords);
 	}
+}
 
-	unsigned int const chunk_generation_radius = 1 + static_cast<unsigned int>(
-		this->generation_radius / static_cast<float>(g_game->chunk_side));
-	ChunkCoords const chunk_generation_center =
-		containing_chunk_coords(this->generation_center);
-	/* Cube of chunks that contains the zone to be generated. */
-	ChunkRect const chunk_generation_rect =
-		ChunkRect{chunk_generation_center, chunk_generation_radius};
-
-	/* Make the list of chunks that are to be generated. */
-	std::vector<ChunkCoords> chunk_generation_candidates;
-	for (ChunkCoords const& walker : chunk_generation_rect)
-	{
-		if (this->chunk_grid->has_complete_mesh(walker))
+void ChunkGenerationManager::unload_no_longer_needed_fields_around(ChunkCoords chunk_coords)
+{
+	/* A chunk that has its B field cannot be having its B field generated (so there is no
+	 * generation step still reading the PTT fields of its neighborhood), and a chunk that has
+	 * its PTT field cannot be having its PTT field generated. A chunk that has its B field
+	 * may still be having its PTT field generated if one of its neighbors needed it. */
+	auto const neighborhood_has_b_fields = [this](ChunkCoords center_chunk_coords){
+		for (ChunkCoords const neighbor_chunk_coords : ChunkRect{center_chunk_coords, 2})
 		{
-			/* Don't generate already generated chunks. */
-			continue;
+			if (not this->chunk_grid->has_b_field(neighbor_chunk_coords))
+			{
+				return false;
+			}
 		}
-		float const distance_to_center = glm::distance(
-			static_cast<glm::vec3>(chunk_center_coords(walker)), this->generation_center);
-		if (distance_to_center > this->generation_radius + g_game->chunk_side)
+		return true;
+	};
+	auto const neighborhood_has_ptt_or_b_fields = [this](ChunkCoords center_chunk_coords){
+		for (ChunkCoords const neighbor_chunk_coords : ChunkRect{center_chunk_coords, 2})
 		{
-			/* Don't generate chunks that are too far.
-			 * The condition leaves a little room for chunks too far to get generated anyway,
-			 * but it does not matter that much. */
-			continue;
+			if (this->chunk_grid->has_ptt_field(neighbor_chunk_coords))
+			{
+				continue;
+			}
+			else if ((not this->chunk_grid->has_b_field(neighbor_chunk_coords)) ||
+				this->generating_data_set.find(ChunkGeneratingData{neighbor_chunk_coords,
+					ChunkGeneratingStep::GENERATE_PTT_FIELD}) != this->generating_data_set.end())
+			{
+				return false;
+			}
 		}
-		chunk_generation_candidates.push_back(walker);
-	}
-
-	/* Sort the candidate chunks per distance to the generation center
-	 * to prioritize the closest chunks.
-	 * The closest chunks are at the end of the vector for the popping to be fast. */
-	std::sort(chunk_generation_candidates.begin(), chunk_generation_candidates.end(),
-		[
-			generation_center = this->generation_center
-		](
-			ChunkCoords const& left, ChunkCoords const& right
-		){
-			glm::vec3 const left_center =
-				static_cast<glm::vec3>(left) * static_cast<float>(g_game->chunk_side);
-			float const left_distance = glm::distance(left_center, generation_center);
-			glm::vec3 const right_center =
-				static_cast<glm::vec3>(right) * static_cast<float>(g_game->chunk_side);
-			float const right_distance = glm::distance(right_center, generation_center);
-			/* Note: Make sure that this order is strict (ie that it returns false when
-			 * left and right are equal) or else std::sort will proceed to perform some
-			 * undefined behavior (that corrupts memory on my machine ><). */
-			return left_distance > right_distance;
-		});
-	
-	for (std::optional<ChunkGeneratingData>& generating_data_opt : this->generating_data_vector)
+		return true;
+	};
+
+	/* Only the fields of the chunks that have the given chunk in their neighborhood may have
+	 * become unneeded. */
+	for (ChunkCoords const neighbor_chunk_coords : ChunkRect{chunk_coords, 2})
 	{
-		if (generating_data_opt.has_value())
+		if (this->chunk_grid->has_ptt_field(neighbor_chunk_coords) &&
+			neighborhood_has_b_fields(neighbor_chunk_coords))
 		{
-			using namespace std::chrono_literals;
-			ChunkGeneratingData& generating_data = generating_data_opt.value();
-			if (generating_data.future.valid()
-				&& generating_data.future.wait_for(0s) == std::future_status::ready)
-			{
-				/* Some data generation has been finished,
-				 * it is time to pick it up and place it in the chunk grid where it belong. */
-				SomeChunkData some_data = generating_data.future.get();
-				ChunkCoords const chunk_coords = generating_data.chunk_coords;
-				ChunkGeneratingStep const step = generating_data.step;
-
-				#if 0
-				std::cout << "Data generated: "
-					<< chunk_coords << " "
-					<< (
-						step == ChunkGeneratingStep::GENERATE_PTG_FIELD ? "PTG" :
-						step == ChunkGeneratingStep::GENERATE_PTT_FIELD ? "PTT" :
-						step == ChunkGeneratingStep::GENERATE_B_FIELD ? "B" :
-						step == ChunkGeneratingStep::MESH ? "mesh" :
-						"?")
-					<< std::endl;
-				#endif
-
-				switch (step)
-				{
-					case ChunkGeneratingStep::GENERATE_PTG_FIELD:
-						assert(std::holds_alternative<ChunkPtgField>(some_data));
-						assert(not this->chunk_grid->has_ptg_field(chunk_coords));
-						this->chunk_grid->ptg_field.insert(std::make_pair(
-							chunk_coords, std::get<ChunkPtgField>(some_data)));
-					break;
-					case ChunkGeneratingStep::GENERATE_PTT_FIELD:
-						assert(std::holds_alternative<ChunkPttField>(some_data));
-						assert(not this->chunk_grid->has_ptt_field(chunk_coords));
-						this->chunk_grid->ptt_field.insert(std::make_pair(
-							chunk_coords, std::get<ChunkPttField>(some_data)));
-					break;
-					case ChunkGeneratingStep::GENERATE_B_FIELD:
-					case ChunkGeneratingStep::DISK_READ_B_FIELD:
-						assert(std::holds_alternative<ChunkBField>(some_data));
-						assert(not this->chunk_grid->has_b_field(chunk_coords));
-						this->chunk_grid->b_field.insert(std::make_pair(
-							chunk_coords, std::get<ChunkBField>(some_data)));
-					break;
-					case ChunkGeneratingStep::DISK_SEARCH:
-						assert(std::holds_alternative<ChunkDiskStorage>(some_data));
-						assert(not this->chunk_grid->has_disk_storage(chunk_coords));
-						this->chunk_grid->disk.insert(std::make_pair(
-							chunk_coords, std::get<ChunkDiskStorage>(some_data)));
-					break;
-					case ChunkGeneratingStep::MESH:
-						assert(std::holds_alternative<ChunkMeshData*>(some_data));
-						assert(not this->chunk_grid->has_complete_mesh(chunk_coords));
-						{
-							Mesh<VertexDataClassic> mesh;
-							ChunkMeshData* chunk_mesh_data = std::get<ChunkMeshData*>(some_data);
-							mesh.vertex_data = std::move(*chunk_mesh_data);
-							delete chunk_mesh_data;
-							mesh.needs_update_opengl_data = true;
-							this->chunk_grid->mesh.insert(std::make_pair(
-								chunk_coords, mesh));
-						}
-					break;
-					default:
-						assert(false);
-					break;
-				}
-
-				generating_data_opt.reset();
-			}
+			this->chunk_grid->unload_ptt_field(neighbor_chunk_coords);
 		}
-		
-		if (not generating_data_opt.has_value())
+		if (this->chunk_grid->has_ptg_field(neighbor_chunk_coords) &&
+			neighborhood_has_ptt_or_b_fields(neighbor_chunk_coords))
 		{
-			while ((not chunk_generation_candidates.empty()) && this->generation_enabled)
-			{
-				/* There is a chunk that would like to see some data generated. */
-				ChunkCoords const chunk_coords = chunk_generation_candidates.back();
-				chunk_generation_candidates.pop_back();
+			this->chunk_grid->unload_ptg_field(neighbor_chunk_coords);
+		}
+	}
+}
 
-				if (not this->needs_generation_step(chunk_coords, ChunkGeneratingStep::MESH))
-				{
-					/* Nevermind, that chunk seem to be already finished. */
-					continue;
-				}
-				std::optional<std::pair<ChunkCoords, ChunkGeneratingStep>> const required =
-					this->required_generation_step(chunk_coords, ChunkGeneratingStep::MESH);
-				if (not required.has_value())
-				{
-					/* The examined data is not quite ready to be generated now,
-					 * and there is nothing to do for it instead of waiting,
-					 * so we go on to see what else we can do. */
-					continue;
-				}
-				auto const [required_chunk_coords, required_step] = required.value();
-
-				#if 0
-				std::cout << "Data request: "
-					<< required_chunk_coords << " "
-					<< (
-						required_step == ChunkGeneratingStep::GENERATE_PTG_FIELD ? "PTG" :
-						required_step == ChunkGeneratingStep::GENERATE_PTT_FIELD ? "PTT" :
-						required_step == ChunkGeneratingStep::GENERATE_B_FIELD ? "B" :
-						required_step == ChunkGeneratingStep::MESH ? "mesh" :
-						"?")
-					<< std::endl;
-				#endif
-
-				ChunkGeneratingData generating_data;
-				generating_data.chunk_coords = required_chunk_coords;
-				generating_data.step = required_step;
-				switch (required_step)
+void ChunkGenerationManager::manage(Nature const& nature)
+{
+	using clock = std::chrono::high_resolution_clock;
+	this->manage_remeshing(nature);
+	this->frame++;
+
+	ChunkGeometry const chunk_geometry = this->chunk_grid->geometry;
+	ChunkCoords const chunk_generation_center =
+		chunk_geometry.containing_chunk_coords(this->generation_center);
+	if (this->generation_offset_table_radius != this->generation_radius)
+	{
+		this->update_generation_offset_table();
+	}
+	bool const generation_center_changed =
+		(not this->last_chunk_generation_center.has_value())
+		|| this->last_chunk_generation_center.value() != chunk_generation_center;
+	if (generation_center_changed)
+	{
+		this->view_metrics = ChunkGenerationViewMetrics{clock::now(), std::nullopt, std::nullopt,
+			not this->last_chunk_generation_center.has_value()};
+		this->last_chunk_generation_center = chunk_generation_center;
+		this->first_not_generated_offset_index = 0;
+		/* Priority to unloading chunks that are too far.
+		 * It seems fast enough for now that it can be done in the main thread,
+		 * and it only has to be done when the generation center moves to an other chunk. */
+		this->unload_far_chunks();
+	}
+	if (this->generation_offset_table_needs_reordering())
+	{
+		this->order_generation_offset_table();
+	}
+
+	/* Some data generations have been finished,
+	 * it is time to pick them up and place them in the chunk grid where they belong. */
+	std::vector<ChunkCoords> landed_mesh_chunk_coords_table;
+	for (ChunkGeneratedData& generated_data : this->completion_queue->take_all())
+	{
+		ChunkCoords const chunk_coords = generated_data.chunk_coords;
+		ChunkGeneratingStep const step = generated_data.step;
+		this->generating_data_set.erase(ChunkGeneratingData{chunk_coords, step});
+
+		#if 0
+		std::cout << "Data generated: "
+			<< chunk_coords << " "
+			<< (
+				step == ChunkGeneratingStep::GENERATE_PTG_FIELD ? "PTG" :
+				step == ChunkGeneratingStep::GENERATE_PTT_FIELD ? "PTT" :
+				step == ChunkGeneratingStep::GENERATE_B_FIELD ? "B" :
+				step == ChunkGeneratingStep::MESH ? "mesh" :
+				"?")
+			<< std::endl;
+		#endif
+
+		switch (step)
+		{
+			case ChunkGeneratingStep::GENERATE_PTG_FIELD:
+				assert(std::holds_alternative<ChunkPtgField>(generated_data.data));
+				assert(not this->chunk_grid->has_ptg_field(chunk_coords));
+				this->chunk_grid->ptg_field.insert(std::make_pair(
+					chunk_coords, std::get<ChunkPtgField>(generated_data.data)));
+			break;
+			case ChunkGeneratingStep::GENERATE_PTT_FIELD:
+				assert(std::holds_alternative<ChunkPttField>(generated_data.data));
+				assert(not this->chunk_grid->has_ptt_field(chunk_coords));
+				this->chunk_grid->ptt_field.insert(std::make_pair(
+					chunk_coords, std::get<ChunkPttField>(generated_data.data)));
+				this->unload_no_longer_needed_fields_around(chunk_coords);
+			break;
+			case ChunkGeneratingStep::GENERATE_B_FIELD:
+			case ChunkGeneratingStep::DISK_READ_B_FIELD:
+				assert(std::holds_alternative<ChunkBField>(generated_data.data));
+				assert(not this->chunk_grid->has_b_field(chunk_coords));
+				this->chunk_grid->b_field.insert(std::make_pair(
+					chunk_coords, std::get<ChunkBField>(generated_data.data)));
+				this->unload_no_longer_needed_fields_around(chunk_coords);
+			break;
+			case ChunkGeneratingStep::MESH:
+				assert(std::holds_alternative<ChunkMeshData*>(generated_data.data));
+				assert(not this->chunk_grid->has_complete_mesh(chunk_coords));
 				{
-					case ChunkGeneratingStep::MESH:
-						generating_data.future = this->thread_pool->give_task(std::bind(
-							[](
-								ChunkCoords chunk_coords,
-								ChunkNeighborhood<ChunkBField> const
-									chunk_neighborhood_b_field,
-								Nature const& nature
-							){
-								return SomeChunkData{generate_chunk_complete_mesh(
-									chunk_coords, chunk_neighborhood_b_field, nature)};
-							},
-							required_chunk_coords,
-							this->chunk_grid->get_b_field_neighborhood(required_chunk_coords),
-							std::cref(nature)));
-					break;
-					case ChunkGeneratingStep::DISK_SEARCH:
-						generating_data.future = this->thread_pool->give_task(std::bind(
-							[](
-								ChunkCoords chunk_coords
-							){
-								return SomeChunkData{search_disk_for_chunk(
-									chunk_coords)};
-							},
-							required_chunk_coords));
-					break;
-					case ChunkGeneratingStep::B_FIELD:
-						assert(false
-							/* The `B_FIELD` variant is not a true generating step, it is a dummy
-							 * step that must be converted into `GENERATE_B_FIELD` or
-							 * `DISK_READ_B_FIELD` to know via which way to generate the B field.
-							 * If we end up here then it means something went wrong and there is a
-							 * bug to fix. */);
-						std::exit(EXIT_FAILURE);
-					break;
-					case ChunkGeneratingStep::DISK_READ_B_FIELD:
-						generating_data.future = this->thread_pool->give_task(std::bind(
-							[](
-								ChunkCoords chunk_coords,
-								ChunkDiskStorage& chunk_disk_storage
-							){
-								return SomeChunkData{read_disk_chunk_b_field(
-									chunk_coords, chunk_disk_storage)};
-							},
-							required_chunk_coords,
-							std::ref(this->chunk_grid->disk[required_chunk_coords])));
-					break;
-					case ChunkGeneratingStep::GENERATE_B_FIELD:
-						generating_data.future = this->thread_pool->give_task(std::bind(
-							[](
-								ChunkCoords chunk_coords,
-								ChunkNeighborhood<ChunkPttField> const
-									chunk_neighborhood_ptt_field,
-								Nature const& nature
-							){
-								return SomeChunkData{generate_chunk_b_field(
-									chunk_coords, chunk_neighborhood_ptt_field, nature)};
-							},
-							required_chunk_coords,
-							this->chunk_grid->get_ptt_field_neighborhood(required_chunk_coords),
-							std::cref(nature)));
-					break;
-					case ChunkGeneratingStep::GENERATE_PTT_FIELD:
-						generating_data.future = this->thread_pool->give_task(std::bind(
-							[](
-								ChunkCoords chunk_coords,
-								ChunkNeighborhood<ChunkPtgField> const
-									chunk_neighborhood_ptg_field,
-								Nature const& nature
-							){
-								return SomeChunkData{generate_chunk_ptt_field(
-									chunk_coords, chunk_neighborhood_ptg_field, nature)};
-							},
-							required_chunk_coords,
-							this->chunk_grid->get_ptg_field_neighborhood(required_chunk_coords),
-							std::cref(nature)));
-					break;
-					case ChunkGeneratingStep::GENERATE_PTG_FIELD:
-						generating_data.future = this->thread_pool->give_task(std::bind(
-							[](
-								ChunkCoords chunk_coords,
-								Nature const& nature
-							){
-								return SomeChunkData{generate_chunk_ptg_field(
-									chunk_coords, nature)};
-							},
-							required_chunk_coords,
-							std::cref(nature)));
-					break;
-					default:
-						assert(false);
-					break;
+					Mesh<VertexDataChunk> mesh;
+					ChunkMeshData* chunk_mesh_data = std::get<ChunkMeshData*>(generated_data.data);
+					mesh.vertex_data = std::move(*chunk_mesh_data);
+					delete chunk_mesh_data;
+					mesh.needs_update_opengl_data = true;
+					this->chunk_grid->mesh.insert(std::make_pair(
+						chunk_coords, std::move(mesh)));
 				}
-				generating_data_opt = std::move(generating_data);
-				break;
-			}
+				landed_mesh_chunk_coords_table.push_back(chunk_coords);
+			break;
+			default:
+				assert(false);
+			break;
 		}
 	}
-}
 
-namespace
-{
+	if (not landed_mesh_chunk_coords_table.empty())
+	{
+		this->update_view_metrics(chunk_generation_center, landed_mesh_chunk_coords_table);
+	}
 
-/* Is the `given_step` being done by the `step_being_done`? */
-bool given_step_is_being_done(ChunkGeneratingStep step_being_done, ChunkGeneratingStep given_step)
-{
-	assert(step_being_done != ChunkGeneratingStep::B_FIELD
-		/* The `B_FIELD` variant is not a step that can be "being done", it is a dummy
-		 * step that must be converted into `GENERATE_B_FIELD` or `DISK_READ_B_FIELD`
-		 * to be done. If it ends up being considered as a step that is "being done"
-		 * then it means something went wrong and there is a bug to fix. */);
-	if (given_step == ChunkGeneratingStep::B_FIELD)
+	if (this->generating_data_set.size() >= this->generating_data_cap
+		|| not this->generation_enabled)
 	{
-		return
-			step_being_done == ChunkGeneratingStep::GENERATE_B_FIELD ||
-			step_being_done == ChunkGeneratingStep::DISK_READ_B_FIELD;
+		/* No new generation step can be started, so there is no need to look for some. */
+		return;
 	}
-	else
+
+	/* The chunks are considered from the closest to the generation center to the farthest,
+	 * starting from the closest one that does not have its mesh yet. */
+	TaskBatch batch;
+	for (unsigned int offset_index = this->first_not_generated_offset_index;
+		offset_index < this->generation_offset_table.size()
+			&& this->generating_data_set.size() < this->generating_data_cap;
+		offset_index++)
 	{
-		return step_being_done == given_step;
+		/* There is a chunk that would like to see some data generated. */
+		ChunkCoords const chunk_coords =
+			chunk_generation_center + this->generation_offset_table[offset_index];
+		if (this->chunk_grid->has_complete_mesh(chunk_coords))
+		{
+			if (offset_index == this->first_not_generated_offset_index)
+			{
+				this->first_not_generated_offset_index++;
+			}
+			continue;
+		}
+
+		if (not this->needs_generation_step(chunk_coords, ChunkGeneratingStep::MESH))
+		{
+			/* Nevermind, that chunk seem to be already finished. */
+			continue;
+		}
+		std::optional<std::pair<ChunkCoords, ChunkGeneratingStep>> const required =
+			this->required_generation_step(chunk_coords, ChunkGeneratingStep::MESH);
+		if (not required.has_value())
+		{
+			/* The examined data is not quite ready to be generated now,
+			 * and there is nothing to do for it instead of waiting,
+			 * so we go on to see what else we can do. */
+			continue;
+		}
+		auto const [required_chunk_coords, required_step] = required.value();
+
+		#if 0
+		std::cout << "Data request: "
+			<< required_chunk_coords << " "
+			<< (
+				required_step == ChunkGeneratingStep::GENERATE_PTG_FIELD ? "PTG" :
+				required_step == ChunkGeneratingStep::GENERATE_PTT_FIELD ? "PTT" :
+				required_step == ChunkGeneratingStep::GENERATE_B_FIELD ? "B" :
+				required_step == ChunkGeneratingStep::MESH ? "mesh" :
+				"?")
+			<< std::endl;
+		#endif
+
+		ChunkGeneratingData generating_data;
+		generating_data.chunk_coords = required_chunk_coords;
+		generating_data.step = required_step;
+		/* The rank of the chunk in the offset table orders the tasks of the same level
+		 * the same way the chunks are considered here. */
+		TaskPriority const priority{
+			chunk_generating_step_priority_level(required_step),
+			static_cast<float>(offset_index)};
+		std::function<SomeChunkData()> task_function;
+		switch (required_step)
+		{
+			case ChunkGeneratingStep::MESH:
+				task_function = std::bind(
+					[](
+						ChunkCoords chunk_coords,
+						ChunkGeometry chunk_geometry,
+						ChunkNeighborhood<ChunkBField> const
+							chunk_neighborhood_b_field,
+						bool padded_neighborhoods,
+						bool greedy_meshing,
+						Nature const& nature
+					){
+						/* The copy is not worth it if the meshing can be skipped. */
+						if (padded_neighborhoods &&
+							not chunk_mesh_is_trivially_empty(chunk_neighborhood_b_field))
+						{
+							PaddedChunkNeighborhoodBField const
+								padded_neighborhood_b_field{chunk_neighborhood_b_field};
+							return SomeChunkData{generate_chunk_complete_mesh(
+								chunk_coords, chunk_geometry,
+								padded_neighborhood_b_field, nature, greedy_meshing)};
+						}
+						return SomeChunkData{generate_chunk_complete_mesh(
+							chunk_coords, chunk_geometry,
+							chunk_neighborhood_b_field, nature, greedy_meshing)};
+					},
+					required_chunk_coords,
+					chunk_geometry,
+					this->chunk_grid->get_b_field_neighborhood(required_chunk_coords),
+					this->chunk_grid->padded_neighborhoods,
+					this->chunk_grid->greedy_meshing,
+					std::cref(nature));
+			break;
+			case ChunkGeneratingStep::B_FIELD:
+				assert(false
+					/* The `B_FIELD` variant is not a true generating step, it is a dummy
+					 * step that must be converted into `GENERATE_B_FIELD` or
+					 * `DISK_READ_B_FIELD` to know via which way to generate the B field.
+					 * If we end up here then it means something went wrong and there is a
+					 * bug to fix. */);
+				std::exit(EXIT_FAILURE);
+			break;
+			case ChunkGeneratingStep::DISK_READ_B_FIELD:
+				task_function = std::bind(
+					[](
+						ChunkCoords chunk_coords,
+						ChunkGeometry chunk_geometry,
+						ChunkSaveWriter const& save_writer,
+						RegionFileTable& region_file_table,
+						ChunkSaveSignature save_signature
+					){
+						/* The B field may not be written yet. */
+						std::optional<ChunkBField> unwritten_b_field =
+							save_writer.unwritten_b_field(chunk_coords);
+						if (unwritten_b_field.has_value())
+						{
+							return SomeChunkData{std::move(unwritten_b_field.value())};
+						}
+						return SomeChunkData{read_disk_chunk_b_field(
+							chunk_coords, chunk_geometry, region_file_table, save_signature)};
+					},
+					required_chunk_coords,
+					chunk_geometry,
+					std::cref(this->chunk_grid->save_writer),
+					std::ref(this->chunk_grid->region_file_table),
+					this->chunk_grid->save_signature);
+			break;
+			case ChunkGeneratingStep::GENERATE_B_FIELD:
+				task_function = std::bind(
+					[](
+						ChunkCoords chunk_coords,
+						ChunkGeometry chunk_geometry,
+						ChunkNeighborhood<ChunkPttField> const
+							chunk_neighborhood_ptt_field,
+						Nature const& nature
+					){
+						return SomeChunkData{generate_chunk_b_field(
+							chunk_coords, chunk_geometry,
+							chunk_neighborhood_ptt_field, nature)};
+					},
+					required_chunk_coords,
+					chunk_geometry,
+					this->chunk_grid->get_ptt_field_neighborhood(required_chunk_coords),
+					std::cref(nature));
+			break;
+			case ChunkGeneratingStep::GENERATE_PTT_FIELD:
+				task_function = std::bind(
+					[](
+						ChunkCoords chunk_coords,
+						ChunkGeometry chunk_geometry,
+						ChunkNeighborhood<ChunkPtgField> const
+							chunk_neighborhood_ptg_field,
+						bool padded_neighborhoods,
+						Nature const& nature
+					){
+						/* The copy is not worth it if the field is trivially homogeneous. */
+						if (padded_neighborhoods &&
+							not chunk_neighborhood_ptg_field.homogeneous_value().has_value())
+						{
+							PaddedChunkNeighborhoodPtgField const
+								padded_neighborhood_ptg_field{chunk_neighborhood_ptg_field};
+							return SomeChunkData{generate_chunk_ptt_field(
+								chunk_coords, chunk_geometry,
+								padded_neighborhood_ptg_field, nature)};
+						}
+						return SomeChunkData{generate_chunk_ptt_field(
+							chunk_coords, chunk_geometry,
+							chunk_neighborhood_ptg_field, nature)};
+					},
+					required_chunk_coords,
+					chunk_geometry,
+					this->chunk_grid->get_ptg_field_neighborhood(required_chunk_coords),
+					this->chunk_grid->padded_neighborhoods,
+					std::cref(nature));
+			break;
+			case ChunkGeneratingStep::GENERATE_PTG_FIELD:
+				task_function = std::bind(
+					[](
+						ChunkCoords chunk_coords,
+						ChunkGeometry chunk_geometry,
+						Nature const& nature
+					){
+						return SomeChunkData{generate_chunk_ptg_field(
+							chunk_coords, chunk_geometry, nature)};
+					},
+					required_chunk_coords,
+					chunk_geometry,
+					std::cref(nature));
+			break;
+			default:
+				assert(false);
+			break;
+		}
+
+		this->generating_data_set.insert(generating_data);
+		batch.add_task(
+			[
+				completion_queue = this->completion_queue,
+				generating_data,
+				task_function = std::move(task_function)
+			](){
+				completion_queue->push(ChunkGeneratedData{
+					generating_data.chunk_coords, generating_data.step, task_function()});
+			},
+			priority);
 	}
+	this->thread_pool->give_batch(batch);
 }
 
-} /* Anonymous namespace. */
-
 bool ChunkGenerationManager::needs_generation_step(
 	ChunkCoords chunk_coords, ChunkGeneratingStep step) const
 {
 	/* Check if the given step for the given chunk is already on its way. */
-	for (std::optional<ChunkGeneratingData> const& generating_data_opt :
-		this->generating_data_vector)
+	auto const is_being_done = [this, chunk_coords](ChunkGeneratingStep step_being_done){
+		return this->generating_data_set.find(ChunkGeneratingData{chunk_coords, step_being_done})
+			!= this->generating_data_set.end();
+	};
+	if (step == ChunkGeneratingStep::B_FIELD)
 	{
-		if (generating_data_opt.has_value()
-			&& generating_data_opt.value().chunk_coords == chunk_coords
-			&& given_step_is_being_done(generating_data_opt.value().step, step))
+		/* The `B_FIELD` variant is not a step that can be "being done", it is a dummy
+		 * step that must be converted into `GENERATE_B_FIELD` or `DISK_READ_B_FIELD`
+		 * to be done. */
+		if (is_being_done(ChunkGeneratingStep::GENERATE_B_FIELD)
+			|| is_being_done(ChunkGeneratingStep::DISK_READ_B_FIELD))
 		{
 			return false;
 		}
 	}
+	else if (is_being_done(step))
+	{
+		return false;
+	}
 
 	/* Check if the given step is already done and stored in the chunk grid. */
 	switch (step)
@@ -1219,9 +3149,6 @@ bool ChunkGenerationManager::needs_generation_step(
 		case ChunkGeneratingStep::GENERATE_PTT_FIELD:
 			return not this->chunk_grid->has_ptt_field(chunk_coords);
 		break;
-		case ChunkGeneratingStep::DISK_SEARCH:
-			return not this->chunk_grid->has_disk_storage(chunk_coords);
-		break;
 		case ChunkGeneratingStep::B_FIELD:
 		case ChunkGeneratingStep::GENERATE_B_FIELD:
 		case ChunkGeneratingStep::DISK_READ_B_FIELD:
@@ -1271,9 +3198,10 @@ std::optional<std::pair<ChunkCoords, ChunkGeneratingStep>>
 			}
 		break;
 		case ChunkGeneratingStep::B_FIELD:
+			/* Whether the chunk is saved is known without accessing the disk
+			 * (see `RegionFileTable`), so it is decided right away. */
 			if (this->load_save_enabled &&
-				this->chunk_grid->has_disk_storage(chunk_coords) &&
-				this->chunk_grid->disk[chunk_coords].exist)
+				this->chunk_grid->has_saved_b_field(chunk_coords))
 			{
 				if (this->needs_generation_step(chunk_coords,
 					ChunkGeneratingStep::B_FIELD))
@@ -1285,19 +3213,6 @@ std::optional<std::pair<ChunkCoords, ChunkGeneratingStep>>
 					return std::nullopt;
 				}
 			}
-			else if (this->load_save_enabled &&
-				not this->chunk_grid->has_disk_storage(chunk_coords))
-			{
-				if (this->needs_generation_step(chunk_coords,
-					ChunkGeneratingStep::DISK_SEARCH))
-				{
-					return std::make_pair(chunk_coords, ChunkGeneratingStep::DISK_SEARCH);
-				}
-				else
-				{
-					return std::nullopt;
-				}
-			}
 			else
 			{
 				return this->required_generation_step(chunk_coords,
@@ -4,74 +4,194 @@
 
 #include "coords.hpp"
 #include "mesh.hpp"
-#include "shaders/classic/classic.hpp"
+#include "component_grid.hpp"
+#include "region.hpp"
+#include "shaders/chunk/chunk.hpp"
 #include <glm/vec3.hpp>
 #include <vector>
 #include <array>
-#include <unordered_map>
+#include <unordered_set>
 #include <optional>
 #include <variant>
 #include <future>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <unordered_map>
+#include <memory>
 #include <tuple>
 #include <fstream>
+#include <string>
+#include <string_view>
+#include <chrono>
 #include <cstdint>
 
 namespace qwy2
 {
 
-/* Returns the coords of the block at the center of the chunk given by chunk_coords. */
-BlockCoords chunk_center_coords(ChunkCoords chunk_coords);
+/* The shape of the chunks of a world (for now only the length of their edges),
+ * from which derives all the chunk-level geometry.
+ * The chunk code is given one explicitly instead of fetching it from some global state,
+ * so that it can run outside of a `Game` and so that worlds with different chunk sides
+ * can live in the same process. */
+class ChunkGeometry
+{
+public:
+	/* The length of the edges of the chunks, in blocks.
+	 * It must be odd, and should be at least 15 or something. */
+	int side;
+
+public:
+	ChunkGeometry();
+	ChunkGeometry(int side);
+
+	/* Returns the number of blocks in one chunk. */
+	unsigned int volume() const;
+
+	/* Returns the coords of the block at the center of the chunk given by chunk_coords. */
+	BlockCoords center_coords(ChunkCoords chunk_coords) const;
+
+	/* Returns the coords of the block at the negativeward corner of the given chunk. */
+	BlockCoords most_negativeward_block_coords(ChunkCoords chunk_coords) const;
+
+	/* Returns the coords of the block at the positiveward corner of the given chunk. */
+	BlockCoords most_positiveward_block_coords(ChunkCoords chunk_coords) const;
+
+	/* Returns the coords of the most negativeward point of the given chunk,
+	 * which is the origin of the chunk-local coords of the vertices of its mesh. */
+	glm::vec3 most_negativeward_corner_coords(ChunkCoords chunk_coords) const;
 
-/* Returns the coords of the block at the negativeward corner of the given chunk. */
-BlockCoords chunk_most_negativeward_block_coords(ChunkCoords chunk_coords);
+	/* Returns the block rect that contains exactly the blocks of the chunk given by
+	 * chunk_coords. */
+	BlockRect block_rect(ChunkCoords chunk_coords) const;
 
-/* Returns the coords of the block at the positiveward corner of the given chunk. */
-BlockCoords chunk_most_positiveward_block_coords(ChunkCoords chunk_coords);
+	/* Returns the block rect that contains exactly the blocks of the given chunk rect. */
+	BlockRect chunk_rect_block_rect(ChunkRect chunk_rect) const;
 
-/* Returns the block rect that contains exactly the blocks of the chunk given by chunk_coords. */
-BlockRect chunk_block_rect(ChunkCoords chunk_coords);
+	/* Returns the chunk-level coords of the chunk that contains the block at the given coords. */
+	ChunkCoords containing_chunk_coords(BlockCoords coords) const;
 
-/* Returns the block rect that contains exactly the blocks of the given chunk rect. */
-BlockRect chunk_rect_block_rect(ChunkRect chunk_rect);
+	/* Returns the chunk-level coords of the chunk that contains the point at the given coords. */
+	ChunkCoords containing_chunk_coords(glm::vec3 coords) const;
 
-/* Returns the chunk-level coords of the chunk that contains the block at the given coords. */
-ChunkCoords containing_chunk_coords(BlockCoords coords);
+	/* Returns the chunk rect of all the chunks that intersect with the given block rect. */
+	ChunkRect containing_chunk_rect(BlockRect block_rect) const;
 
-/* Returns the chunk-level coords of the chunk that contains the point at the given coords. */
-ChunkCoords containing_chunk_coords(glm::vec3 coords);
+	/* Returns the index in the data of a chunk field of the block at the given coords
+	 * that are relative to the most negativeward block of the chunk. */
+	unsigned int local_index(BlockCoords local_coords) const;
+};
 
-/* Returns the chunk rect of all the chunks that intersect with the given block rect. */
-ChunkRect containing_chunk_rect(BlockRect block_rect);
+/* Is the chunk generation code specialized for the given chunk side?
+ * If not, then it still works but takes a slower generic path. */
+bool chunk_side_is_specialized(int chunk_side);
 
 /* Returns the box that contains exactly the blocks in the given block rect. */
 AlignedBox block_rect_box(BlockRect block_rect);
 
 /* Grid of values, one value per block, for one chunk.
- * As this is mostly a pointer to the data, passing it by value does not copy the data. */
+ * As this is mostly a pointer to the data, passing it by value does not copy the data,
+ * the copies share the data which is freed when the last of them is destroyed
+ * (or stops using it, like when made homogeneous). A chunk neighborhood given to some
+ * generation task thus keeps the data it reads alive even if the chunks are unloaded.
+ * The values can be stored in one of three ways:
+ * - In a plain array of values, which is how fields are generated.
+ * - Homogeneous, when all the values are the same (like a chunk of air or a chunk deep
+ *   underground), in which case only that value is stored, see `make_homogeneous_if_possible`.
+ * - Packed, as indices in a palette of the values that appear in the field, each index using
+ *   only 1, 2, 4 or 8 bits, see `pack`. A chunk rarely has more than a few block types,
+ *   so this makes B fields a lot smaller. */
 template<typename FieldValueType>
 class ChunkField
 {
 public:
 	using ValueType = FieldValueType;
 
+private:
+	class PackedValues
+	{
+	public:
+		unsigned int bits_per_value;
+		std::vector<ValueType> palette;
+		/* Indices in the palette, `64 / bits_per_value` per word. */
+		std::vector<std::uint64_t> words;
+
+	public:
+		ValueType get(unsigned int index) const;
+	};
+
 public:
 	ChunkCoords chunk_coords;
+	ChunkGeometry geometry;
 private:
-	ValueType* data;
+	/* Null if the field is homogeneous or packed. Comes from (and goes back to)
+	 * the `FieldBufferPool` of the value type. Like the packed values, the array is never
+	 * modified once shared, the field gets its own copy to modify instead (see
+	 * `make_data_unshared`). */
+	std::shared_ptr<ValueType[]> data;
+	ValueType value_if_homogeneous;
+	/* Null if the field is not packed. The packed values are never modified once shared, they
+	 * are replaced instead (see `set`), so that copies of the field that are being read by
+	 * some other threads keep valid values (and never see the modifications). */
+	std::shared_ptr<PackedValues const> packed_values;
 
 public:
 	ChunkField();
-	ChunkField(ChunkCoords chunk_coords);
-	ChunkField(ChunkCoords chunk_coords, ValueType* data);
-	~ChunkField();
+	ChunkField(ChunkCoords chunk_coords, ChunkGeometry geometry);
+
+	/* Returns a homogeneous field in which all the values are the given value. */
+	static ChunkField homogeneous(ChunkCoords chunk_coords, ChunkGeometry geometry,
+		ValueType value);
+
+	/* The non-const access makes the field use a plain array first,
+	 * as the returned value may be modified. Prefer `set` to modify a field that is not
+	 * being generated. */
 	ValueType& operator[](BlockCoords coords);
-	ValueType const& operator[](BlockCoords coords) const;
+	ValueType operator[](BlockCoords coords) const;
+
+	/* Same as the const [] operator, but from the index given by `ChunkGeometry::local_index`. */
+	ValueType get(unsigned int local_index) const;
+
+	/* Sets the value at the given coords, keeping the field homogeneous or packed if it is
+	 * (a homogeneous field becomes packed, and the packed values are repacked with more bits
+	 * per value if their palette is full). */
+	void set(BlockCoords coords, ValueType value);
 
 	/* Access raw field data. Access to values should be performed via [] operator,
-	 * this is intended for use in stuff like write to disk. */
+	 * this is intended for use in stuff like write to disk.
+	 * A homogeneous or packed field has no raw data (null is returned).
+	 * The non-const access copies the array first if it is shared with other copies. */
 	ValueType* raw_data();
+	ValueType const* raw_data() const;
+
+	bool is_homogeneous() const;
+	bool is_packed() const;
+
+	/* The value of all the blocks of a homogeneous field. */
+	ValueType const& homogeneous_value() const;
+
+	/* If all the values are the same, then frees the array of values and makes the field
+	 * homogeneous. Returns true if the field ends up homogeneous. */
+	bool make_homogeneous_if_possible();
 
-	void free_data();
+	/* Makes a field that uses a plain array homogeneous if possible, else packed if there are
+	 * at most 256 different values (else it keeps the array). */
+	void pack();
+
+	/* Makes the field use a plain array of values again. */
+	void unpack();
+
+	/* Number of bytes that the values of the field occupy in memory. */
+	std::size_t allocated_bytes() const;
+
+private:
+	/* Returns an uninitialized array of values of the given volume from the pool. */
+	static std::shared_ptr<ValueType[]> allocate_data(unsigned int volume);
+
+	/* Copies the array of values if it is shared with other copies of the field,
+	 * so that it can be modified without the other copies seeing it (copy-on-write).
+	 * The field must use a plain array. */
+	void make_data_unshared();
 };
 
 /* The PTG field (Plain Terrain Generation)
@@ -91,6 +211,8 @@ public:
 	BlockTypeId type_id;
 public:
 	bool is_air() const;
+	bool operator==(Block const& other) const;
+	bool operator!=(Block const& other) const;
 };
 
 /* The B field is the actual grid of blocks contained by the chunk. */
@@ -113,14 +235,66 @@ private:
 public:
 	ChunkNeighborhood();
 	ValueType& operator[](BlockCoords coords);
-	ValueType const& operator[](BlockCoords coords) const;
+	ValueType operator[](BlockCoords coords) const;
+
+	/* Same as the [] operator, but with the index math done by the given chunk geometry,
+	 * which must describe the chunk side of the fields. This is used by the chunk
+	 * generation code (in chunk.cpp) with compile-time chunk geometries for the index math
+	 * to be constant-folded. */
+	template<typename ChunkGeometryType>
+	ValueType get(BlockCoords coords, ChunkGeometryType chunk_geometry) const;
 
 	ChunkRect chunk_rect() const;
+	ChunkGeometry geometry() const;
+
+	/* If all the fields are homogeneous with the same value, then returns that value. */
+	std::optional<ValueType> homogeneous_value() const;
+
+	/* Returns the field of the chunk at the given chunk-level coords relative to the
+	 * chunk at the center (so each coord is -1, 0 or 1). */
+	FieldType const& field(ChunkCoords offset) const;
 
 	friend class ChunkGrid;
+	template<typename, int> friend class PaddedChunkNeighborhood;
 };
 
-using ChunkMeshData = std::vector<VertexDataClassic>;
+/* Copy of the values of a chunk neighborhood that are in the chunk at its center or
+ * at most `Padding` blocks away from it, in one contiguous buffer (with the same layout as
+ * a chunk field, just bigger). Reading a value is then a plain strided indexing instead of
+ * the chunk lookup that `ChunkNeighborhood` has to do for each access,
+ * at the cost of the copy. */
+template<typename ChunkFieldType, int Padding>
+class PaddedChunkNeighborhood
+{
+public:
+	using FieldType = ChunkFieldType;
+	using ValueType = typename FieldType::ValueType;
+	static constexpr int padding = Padding;
+
+public:
+	ChunkCoords chunk_coords;
+	ChunkGeometry geometry;
+private:
+	/* The most negativeward block of the padded cube. */
+	BlockCoords coords_min;
+	std::vector<ValueType> data;
+
+public:
+	PaddedChunkNeighborhood(ChunkNeighborhood<ChunkFieldType> const& chunk_neighborhood);
+	ValueType const& operator[](BlockCoords coords) const;
+
+	/* Same as the [] operator, but with the index math done by the given chunk geometry,
+	 * see `ChunkNeighborhood::get`. */
+	template<typename ChunkGeometryType>
+	ValueType const& get(BlockCoords coords, ChunkGeometryType chunk_geometry) const;
+};
+
+/* The generation steps only need the values that are close to the generated chunk,
+ * these are the paddings they need. */
+using PaddedChunkNeighborhoodPtgField = PaddedChunkNeighborhood<ChunkPtgField, 2>;
+using PaddedChunkNeighborhoodBField = PaddedChunkNeighborhood<ChunkBField, 1>;
+
+using ChunkMeshData = std::vector<VertexDataChunk>;
 
 class Nature;
 
@@ -128,6 +302,7 @@ class Nature;
  * Can be called in isolation, given that the nature is not modified before it returns. */
 ChunkPtgField generate_chunk_ptg_field(
 	ChunkCoords chunk_coords,
+	ChunkGeometry chunk_geometry,
 	Nature const& nature);
 
 /* Generates the PTT field of the chunk at the given chunk-level coords,
@@ -135,24 +310,48 @@ ChunkPtgField generate_chunk_ptg_field(
  * Can be called in isolation, given that the nature is not modified before it returns. */
 ChunkPttField generate_chunk_ptt_field(
 	ChunkCoords chunk_coords,
+	ChunkGeometry chunk_geometry,
 	ChunkNeighborhood<ChunkPtgField> const chunk_neighborhood_ptg_field,
 	Nature const& nature);
+ChunkPttField generate_chunk_ptt_field(
+	ChunkCoords chunk_coords,
+	ChunkGeometry chunk_geometry,
+	PaddedChunkNeighborhoodPtgField const& padded_neighborhood_ptg_field,
+	Nature const& nature);
 
 /* Generates the B field of the chunk at the given chunk-level coords,
  * using the PTT field of the nearby chunks.
  * Can be called in isolation, given that the nature is not modified before it returns. */
 ChunkBField generate_chunk_b_field(
 	ChunkCoords chunk_coords,
+	ChunkGeometry chunk_geometry,
 	ChunkNeighborhood<ChunkPttField> const chunk_neighborhood_ptt_field,
 	Nature const& nature);
 
 /* Generates the mesh data of the chunk at the given chunk-level coords,
  * using the B field of the nearby chunks.
+ * If `greedy_meshing` is true, then faces that look the same are merged into bigger quads
+ * (which makes for way less vertices), else each visible block face gets its own quad.
  * Can be called in isolation, given that the nature is not modified before it returns. */
 ChunkMeshData* generate_chunk_complete_mesh(
 	ChunkCoords chunk_coords,
+	ChunkGeometry chunk_geometry,
 	ChunkNeighborhood<ChunkBField> const chunk_neighborhood_b_field,
-	Nature const& nature);
+	Nature const& nature,
+	bool greedy_meshing);
+ChunkMeshData* generate_chunk_complete_mesh(
+	ChunkCoords chunk_coords,
+	ChunkGeometry chunk_geometry,
+	PaddedChunkNeighborhoodBField const& padded_neighborhood_b_field,
+	Nature const& nature,
+	bool greedy_meshing);
+
+/* Is the mesh of the chunk at the center of the given neighborhood known to be empty without
+ * having to look at its blocks one by one? It is the case if the chunk is only air, or if
+ * it is only non-air blocks and all the blocks touching its faces are non-air too.
+ * Only homogeneous fields and the faces of the neighbors are looked at, so it is cheap. */
+bool chunk_mesh_is_trivially_empty(
+	ChunkNeighborhood<ChunkBField> const& chunk_neighborhood_b_field);
 
 class Entity;
 
@@ -166,47 +365,214 @@ public:
 	ChunkEntityTable();
 };
 
-/* Handles the disk storage of a chunk's data.
+/* Handles the disk storage of a chunk's data (that is in a region file, see `RegionFile`).
+ * Whether the chunk has saved data is not recorded here, the `RegionFileTable` knows.
  * TODO: Make this better. */
 class ChunkDiskStorage
 {
 public:
 	ChunkCoords chunk_coords;
 
-	/* Does the chunk actually has data stored on disk? */
-	bool exist;
-
 	/* Was this chunk's B field modified since the last saving? */
 	bool modified;
 
-	std::string file_name;
-
 public:
-	ChunkDiskStorage();
 	ChunkDiskStorage(ChunkCoords chunk_coords);
 };
 
-ChunkDiskStorage search_disk_for_chunk(ChunkCoords chunk_coords);
-ChunkBField read_disk_chunk_b_field(ChunkCoords chunk_coords,
-	ChunkDiskStorage& chunk_disk_storage);
-void write_disk_chunk_b_field(ChunkCoords chunk_coords,
-	ChunkDiskStorage& chunk_disk_storage, ChunkBField chunk_b_field);
+/* What the saved data of a chunk records about the world it was saved in,
+ * so that loading it in a world it does not fit in can be detected. */
+class ChunkSaveSignature
+{
+public:
+	/* Chunks saved with an other chunk side cannot be loaded. */
+	std::int32_t chunk_side;
+
+	/* Chunks saved with an other terrain generator (identified by a hash of its name)
+	 * or seed can be loaded, but they will not match the chunks generated around them. */
+	std::uint32_t terrain_generator_id;
+	std::int32_t seed;
+
+public:
+	ChunkSaveSignature();
+	ChunkSaveSignature(ChunkGeometry chunk_geometry,
+		std::string_view terrain_generator_name, int seed);
+};
+
+/* The saved data of a chunk is a versioned header (with the signature and a checksum)
+ * followed by its B field compressed as a palette of the block types it contains and runs
+ * of blocks of the same type. Data saved before that format (just the raw B field) can
+ * still be deserialized, but it gets no check. Deserializing data that does not fit
+ * the given signature (other chunk side) or that is corrupted is a fatal error. */
+std::vector<char> serialize_chunk_b_field(ChunkBField const& chunk_b_field,
+	ChunkSaveSignature const& save_signature);
+ChunkBField deserialize_chunk_b_field(ChunkCoords chunk_coords, ChunkGeometry chunk_geometry,
+	char const* data, std::size_t byte_size, ChunkSaveSignature const& save_signature);
+
+ChunkBField read_disk_chunk_b_field(ChunkCoords chunk_coords, ChunkGeometry chunk_geometry,
+	RegionFileTable& region_file_table, ChunkSaveSignature const& save_signature);
+
+/* Writes the B fields it is given to the region files in a thread of its own, so that
+ * saving chunks (when they are unloaded or when quitting) does not block the main thread.
+ * The B fields waiting to be written are kept by chunk, so saving a chunk again before it
+ * was written only replaces the B field to write. The writing thread takes all the waiting
+ * B fields at once and writes them as a batch (sorted so that the chunks of a region are
+ * written together, and flushing the region files once per batch).
+ * The number of waiting B fields is bounded, saving blocks when there is no more room.
+ * A B field that is waiting (or being written) is not in the region files yet, so the
+ * saved data of a chunk must be looked for here first (see `unwritten_b_field`).
+ * All the methods can be called concurrently by different threads. */
+class ChunkSaveWriter
+{
+public:
+	static constexpr unsigned int MAX_WAITING_COUNT = 512;
+
+private:
+	RegionFileTable* region_file_table;
+	ChunkSaveSignature save_signature;
+
+	mutable std::mutex mutex;
+	/* Notified when there are B fields to write or when the thread should finish. */
+	std::condition_variable work_condition_variable;
+	/* Notified when a batch is taken or written. */
+	std::condition_variable progress_condition_variable;
+	std::unordered_map<ChunkCoords, ChunkBField, ChunkCoords::Hash> waiting_table;
+	/* The batch being written by the thread. */
+	std::unordered_map<ChunkCoords, ChunkBField, ChunkCoords::Hash> writing_table;
+	bool thread_should_finish;
+	unsigned int written_count;
+
+	/* Not joinable if the writer was not started. */
+	std::thread thread;
+
+public:
+	ChunkSaveWriter(RegionFileTable* region_file_table);
+	/* Writes what remains to be written before returning. */
+	~ChunkSaveWriter();
+
+	/* Starts the writing thread, saving chunks before that is an error. */
+	void start(ChunkSaveSignature save_signature);
+	bool is_started() const;
+
+	/* The given B field is written later, its saved data is the one it has now
+	 * even if the chunk is modified in the meantime. */
+	void save(ChunkBField const& chunk_b_field);
+
+	bool has_unwritten_b_field(ChunkCoords chunk_coords) const;
+	std::optional<ChunkBField> unwritten_b_field(ChunkCoords chunk_coords) const;
+
+	/* The number of B fields waiting or being written. */
+	unsigned int unwritten_count() const;
+	/* The number of B fields written since the writer started. */
+	unsigned int total_written_count() const;
+
+	/* Waits for all the saved B fields to be written, for at most the given duration
+	 * (to allow reporting some progress), returns true if they all are. */
+	bool wait_until_all_written(std::chrono::milliseconds timeout);
+
+private:
+	void thread_work();
+};
+
+/* Records which quads of a chunk mesh are the faces of which block of the chunk, which allows
+ * to remesh only a few blocks when some blocks are modified (see `ChunkGrid::set_block`).
+ * Each block owns a range of quads in the mesh that may be bigger than its face count,
+ * the unused quads of a range are degenerate (all their vertices are the same) so they
+ * are not rendered. Ranges that are owned by no block (because the block that owned it needed
+ * a bigger range) are holes that can be reused. Only makes sense without greedy meshing. */
+class ChunkMeshBlockTable
+{
+public:
+	class QuadRange
+	{
+	public:
+		std::uint32_t first_quad;
+		std::uint32_t quad_count;
+	};
+
+public:
+	/* Indexed as chunk fields are. */
+	std::vector<QuadRange> block_range_table;
+	std::vector<QuadRange> hole_table;
+
+public:
+	ChunkMeshBlockTable(ChunkGeometry chunk_geometry);
+
+	/* Gives a range of the given number of quads that is owned by no block,
+	 * taken from the holes if possible or else from the end of the given mesh (that grows). */
+	QuadRange allocate_range(std::uint32_t quad_count, ChunkMeshData& mesh);
+};
+
+/* Same as `generate_chunk_complete_mesh` without greedy meshing,
+ * but also fills the given block table so that blocks can be remeshed individually. */
+ChunkMeshData* generate_chunk_complete_mesh_and_block_table(
+	ChunkCoords chunk_coords,
+	ChunkGeometry chunk_geometry,
+	ChunkNeighborhood<ChunkBField> const chunk_neighborhood_b_field,
+	Nature const& nature,
+	ChunkMeshBlockTable& block_table);
 
-template <typename ComponentType>
-using ChunkComponentGrid = std::unordered_map<ChunkCoords, ComponentType, ChunkCoords::Hash>;
+/* The result of the complete remeshing of a chunk after some blocks were modified
+ * (see `ChunkGrid::set_block`), the block table is there only without greedy meshing. */
+class ChunkRemeshResult
+{
+public:
+	ChunkMeshData* mesh_data;
+	std::optional<ChunkMeshBlockTable> block_table;
+};
 
 class ChunkGrid
 {
 private:
 public:
+	/* The shape of all the chunks of the grid. */
+	ChunkGeometry geometry;
+
+	/* The directory (with a trailing '/') in which the region files are to be found. */
+	std::string chunk_save_directory;
+	RegionFileTable region_file_table;
+
+	/* Recorded in the saved chunks, set by default to the geometry of the grid only. */
+	ChunkSaveSignature save_signature;
+
+	/* Saving is disabled until the writer is started (with the save signature). */
+	ChunkSaveWriter save_writer;
+
+	/* If set to true, then not-modified chunks will NOT be saved (given load/save is enabled)
+	 * as they can just be re-generated. This allows to save a lot of disk space.
+	 * If set to false, then all generated chunks will be saved to the disk. */
+	bool save_only_modified;
+
+	/* If set to true, then the generation steps that read a lot around each block
+	 * (PTT field generation and meshing) first copy the neighborhood they read from into
+	 * a `PaddedChunkNeighborhood` and read from that copy. */
+	bool padded_neighborhoods;
+
+	/* If set to true, then the chunk meshes are generated with greedy meshing,
+	 * see `generate_chunk_complete_mesh`. */
+	bool greedy_meshing;
+
 	ChunkComponentGrid<ChunkPtgField> ptg_field;
 	ChunkComponentGrid<ChunkPttField> ptt_field;
 	ChunkComponentGrid<ChunkBField> b_field;
-	ChunkComponentGrid<Mesh<VertexDataClassic>> mesh;
+	ChunkComponentGrid<Mesh<VertexDataChunk>> mesh;
+	/* Only for chunks that had some blocks modified, see `set_block`. */
+	ChunkComponentGrid<ChunkMeshBlockTable> mesh_block_table;
 	ChunkComponentGrid<ChunkEntityTable> entity_table;
 	ChunkComponentGrid<ChunkDiskStorage> disk;
 
+	/* Chunks that need to be completely remeshed due to some of their blocks being modified,
+	 * with the time of the oldest such modification. These remeshings are done asynchronously
+	 * by the `ChunkGenerationManager`, meanwhile the old meshes are still rendered. */
+	ChunkComponentGrid<std::chrono::high_resolution_clock::time_point> remesh_request;
+
 public:
+	ChunkGrid(ChunkGeometry geometry, std::string_view chunk_save_directory);
+
+	/* Gives ring buffers of the given side to all the component grids (see
+	 * `ChunkComponentGrid::use_ring_buffer`), the grid must be empty. */
+	void use_ring_buffer(unsigned int ring_side);
+
 	bool has_ptg_field(ChunkCoords chunk_coords) const;
 	bool has_ptt_field(ChunkCoords chunk_coords) const;
 	bool has_b_field(ChunkCoords chunk_coords) const;
@@ -214,6 +580,10 @@ public:
 	bool has_entity_table(ChunkCoords chunk_coords) const;
 	bool has_disk_storage(ChunkCoords chunk_coords) const;
 
+	/* Does the chunk have a saved B field (in the region files or still to be written)?
+	 * Does not access the disk. */
+	bool has_saved_b_field(ChunkCoords chunk_coords) const;
+
 	bool has_ptg_field_neighborhood(ChunkCoords center_chunk_coords) const;
 	bool has_ptt_field_neighborhood(ChunkCoords center_chunk_coords) const;
 	bool has_b_field_neighborhood(ChunkCoords center_chunk_coords) const;
@@ -227,12 +597,23 @@ public:
 
 	bool block_is_air_or_unloaded(BlockCoords coords) const;
 
-	void set_block(Nature const* nature,
-		BlockCoords coords, BlockTypeId new_type_id);
+	/* Modifies a block and updates the meshes accordingly. Without greedy meshing, only the
+	 * modified block and its neighbors (due to ambiant occlusion) are remeshed in place
+	 * (the first time a block of some chunk is modified, that chunk is fully remeshed
+	 * to get its `ChunkMeshBlockTable`), else the concerned chunks are fully remeshed.
+	 * Full remeshings are only requested here (see `remesh_request`), so that they do not
+	 * block the main thread. */
+	void set_block(BlockCoords coords, BlockTypeId new_type_id);
 
 	void add_entity(Entity* entity);
 
 	void unload(ChunkCoords chunk_coords);
+
+	/* Frees and forgets the given field of the given chunk, if any. */
+	void unload_ptg_field(ChunkCoords chunk_coords);
+	void unload_ptt_field(ChunkCoords chunk_coords);
+
+	/* Only hand the B fields to the `save_writer`, that writes them later. */
 	void save_b_field_if_necessary(ChunkCoords chunk_coords);
 	void save_all_that_is_necessary();
 
@@ -244,13 +625,12 @@ class Nothing{};
 using SomeChunkData =
 	std::variant<
 		ChunkPtgField, ChunkPttField, ChunkBField, ChunkMeshData*,
-		ChunkDiskStorage, Nothing>;
+		Nothing>;
 
 enum class ChunkGeneratingStep
 {
 	GENERATE_PTG_FIELD,
 	GENERATE_PTT_FIELD,
-	DISK_SEARCH,
 	B_FIELD, /* Can "resolves" itself into either `DISK_READ_B_FIELD` or `GENERATE_B_FIELD`. */
 	DISK_READ_B_FIELD,
 	GENERATE_B_FIELD,
@@ -259,12 +639,107 @@ enum class ChunkGeneratingStep
 	DISK_WRITE_B_FIELD,
 };
 
+/* A generation step of a chunk that is undergoing (possibly in an other thread). */
 class ChunkGeneratingData
 {
 public:
 	ChunkCoords chunk_coords;
 	ChunkGeneratingStep step;
-	std::future<SomeChunkData> future;
+
+public:
+	bool operator==(ChunkGeneratingData const& other) const;
+
+	class Hash
+	{
+	public:
+		std::size_t operator()(ChunkGeneratingData const& generating_data) const noexcept;
+	};
+};
+
+/* Data generated by a generation step of a chunk, waiting to be placed in the chunk grid. */
+class ChunkGeneratedData
+{
+public:
+	ChunkCoords chunk_coords;
+	ChunkGeneratingStep step;
+	SomeChunkData data;
+};
+
+/* Where the generation tasks (running in other threads) put the data they generated,
+ * for the main thread to pick them up all at once instead of polling each task. */
+class ChunkGenerationCompletionQueue
+{
+private:
+	std::mutex mutex;
+	std::vector<ChunkGeneratedData> generated_data_vector;
+
+public:
+	void push(ChunkGeneratedData&& generated_data);
+
+	/* Returns all the generated data pushed so far, and empties the queue. */
+	std::vector<ChunkGeneratedData> take_all();
+};
+
+/* A complete remeshing of a chunk requested by block modifications
+ * (see `ChunkGrid::remesh_request`) that is waiting or undergoing in an other thread. */
+class ChunkRemeshingData
+{
+public:
+	/* The time and frame (counted in calls to `ChunkGenerationManager::manage`) of the
+	 * oldest block modification that the remeshing takes into account. */
+	std::chrono::high_resolution_clock::time_point edit_time;
+	unsigned int edit_frame;
+
+	/* Only valid once the remeshing has been given to the thread pool. */
+	std::future<ChunkRemeshResult> future;
+};
+
+/* How long it took for a block modification to get its remeshed chunk in the chunk grid. */
+class ChunkRemeshLatency
+{
+public:
+	unsigned int frames;
+	float milliseconds;
+};
+
+/* Weights that make some chunks be generated before other chunks that are as close or
+ * even closer to the generation center. A chunk is considered as if its distance to the
+ * generation center was divided by 1 plus the sum of the weights that apply to it,
+ * thus all weights at 0 means that the closest chunks are generated first. */
+class ChunkGenerationPriorityWeights
+{
+public:
+	/* Applies to the chunks that are in the view of the player camera. */
+	float view;
+
+	/* Applies to the chunks that are in the direction in which the player moves,
+	 * scaled by how well they are aligned with that direction. */
+	float motion;
+
+	/* Applies to the chunks right below the player when the player is falling. */
+	float falling;
+
+public:
+	ChunkGenerationPriorityWeights();
+	bool are_all_zero() const;
+};
+
+/* Measures of how fast the player gets to see stuff, to compare generation priorities.
+ * The times are in seconds since the last time the generation center moved to an other chunk
+ * (which happens when the player spawns). */
+class ChunkGenerationViewMetrics
+{
+public:
+	std::chrono::high_resolution_clock::time_point start_time;
+
+	/* When a chunk in view first got a non-empty mesh. */
+	std::optional<float> time_to_first_visible_ground;
+
+	/* When all the chunks in view got their mesh. */
+	std::optional<float> time_to_fill_view;
+
+	/* Was the start time when the player spawned? */
+	bool is_since_spawn;
 };
 
 class ThreadPool;
@@ -297,13 +772,60 @@ public:
 	 * and saved to the disk. */
 	bool load_save_enabled;
 
-	/* If set to true, then not-modified chunks will NOT be saved (given load/save is enabled)
-	 * as they can just be re-generated. This allows to save a lot of disk space.
-	 * If set to false, then all generated chunks will be saved to the disk. */
-	bool save_only_modified;
+	/* The offsets (from the chunk containing the generation center) of the chunks that
+	 * are in the generated zone, ordered from the closest to the farthest.
+	 * It is computed once for the generation radius it was computed with. */
+	std::vector<ChunkCoords> generation_offset_table;
+	float generation_offset_table_radius;
+
+	/* The chunk that contained the generation center at the last call to `manage`. */
+	std::optional<ChunkCoords> last_chunk_generation_center;
+
+	/* What the player sees and how the player moves, to be updated at every frame.
+	 * The view is approximated by a cone of the given half angle (in radians) around the
+	 * given direction, which is a bit wider than the actual view. */
+	glm::vec3 view_direction;
+	float view_half_angle;
+	glm::vec3 player_motion;
+	bool player_is_falling;
+
+	ChunkGenerationPriorityWeights priority_weights;
+
+	/* The view direction, normalized motion (or zero when not moving) and falling state
+	 * for which the generation offset table is currently ordered (if some weights are set). */
+	glm::vec3 ordered_view_direction;
+	glm::vec3 ordered_motion_direction;
+	bool ordered_falling;
+
+	ChunkGenerationViewMetrics view_metrics;
+
+	/* All the chunks given by the offsets that come before this index have their mesh,
+	 * so that they do not have to be considered again while the generation center
+	 * stays in the same chunk. */
+	unsigned int first_not_generated_offset_index;
+
+	/* The maximum number of generation steps that can be undergoing at the same time
+	 * (the remeshings requested by block modifications are not counted). */
+	unsigned int generating_data_cap;
+
+	/* The generation steps that are undergoing (possibly in an other thread). */
+	std::unordered_set<ChunkGeneratingData, ChunkGeneratingData::Hash> generating_data_set;
+
+	/* Shared with the generation tasks, that may outlive the manager. */
+	std::shared_ptr<ChunkGenerationCompletionQueue> completion_queue;
 
-	/* The data that are undergoing generation (possibly in an other thread). */
-	std::vector<std::optional<ChunkGeneratingData>> generating_data_vector;
+	/* The remeshings requested by block modifications that are undergoing (given to the
+	 * thread pool with high priority) and that are waiting for the undergoing remeshing
+	 * of their chunk to finish (due to more recent block modifications) or for their chunk
+	 * to have its mesh and the B fields of its neighborhood. */
+	ChunkComponentGrid<ChunkRemeshingData> remeshing_data;
+	ChunkComponentGrid<ChunkRemeshingData> waiting_remeshing_data;
+
+	/* The number of calls to `manage` so far. */
+	unsigned int frame;
+
+	/* The worst latency of the remeshings that landed during the last call to `manage`. */
+	std::optional<ChunkRemeshLatency> last_remesh_latency;
 
 public:
 	ChunkGenerationManager();
@@ -313,6 +835,38 @@ public:
 	void manage(Nature const& nature);
 
 private:
+	/* Part of `manage` that handles the remeshings requested by block modifications,
+	 * they have priority over the generation of new chunks. */
+	void manage_remeshing(Nature const& nature);
+
+	void update_generation_offset_table();
+
+	/* Orders the generation offset table by the distance modified by the priority weights,
+	 * for the current view direction, motion and falling state. */
+	void order_generation_offset_table();
+
+	/* Has the view, motion or falling state changed enough since the last ordering of the
+	 * generation offset table for the priority weights to order it differently? */
+	bool generation_offset_table_needs_reordering() const;
+
+	/* Is the chunk at the given offset from the chunk containing the generation center
+	 * (at least partially) in the cone around the given view direction? */
+	bool offset_is_in_view(ChunkCoords offset, glm::vec3 view_direction) const;
+
+	/* Called when some chunk meshes landed, to measure the view metrics that are yet to be. */
+	void update_view_metrics(ChunkCoords chunk_generation_center,
+		std::vector<ChunkCoords> const& landed_mesh_chunk_coords_table);
+
+	/* Unloads the chunks that are out of the generated zone and of the unloading margin. */
+	void unload_far_chunks();
+
+	/* The PTG fields are only read to generate the PTT fields of their neighborhoods,
+	 * and the PTT fields to generate the B fields of their neighborhoods. Once the chunks of
+	 * the neighborhood of a chunk all have what these fields are used for, the fields of that
+	 * chunk are no longer needed and are unloaded by this, which is to be called when a PTT
+	 * field or a B field of the given chunk has been placed in the chunk grid. */
+	void unload_no_longer_needed_fields_around(ChunkCoords chunk_coords);
+
 	/* Does the given chunk needs to have the given generation step to be started?
 	 * Returning false means that the given step is already done or on its way. */
 	bool needs_generation_step(ChunkCoords chunk_coords, ChunkGeneratingStep step) const;
@@ -168,7 +168,7 @@ void register_builtin_command_names()
 				if (not g_game->player.box.containing_block_rect().contains(coords))
 				{
 					BlockTypeId const new_type_id = 3;
-					g_game->chunk_grid->set_block(g_game->nature, coords, new_type_id);
+					g_game->chunk_grid->set_block(coords, new_type_id);
 					std::cout << "Placed block at " << coords << "." << std::endl;
 				}
 			}
@@ -182,7 +182,7 @@ void register_builtin_command_names()
 			{
 				BlockCoords const coords = g_game->pointed_face_opt->internal_coords;
 				BlockTypeId const new_type_id = 0;
-				g_game->chunk_grid->set_block(g_game->nature, coords, new_type_id);
+				g_game->chunk_grid->set_block(coords, new_type_id);
 				std::cout << "Breaked block at " << coords << "." << std::endl;
 			}
 		});
@@ -330,7 +330,7 @@ void register_builtin_command_names()
 			assert(args.empty());
 			BlockCoords const coords = g_game->player.box.center - glm::vec3{0.0f, 0.0f, 1.9f};
 			BlockTypeId const new_type_id = 3;
-			g_game->chunk_grid->set_block(g_game->nature, coords, new_type_id);
+			g_game->chunk_grid->set_block(coords, new_type_id);
 			std::cout << "Placed block below the player at " << coords << "." << std::endl;
 		});
 
@@ -0,0 +1,485 @@
+
+#include "component_grid.hpp"
+#include "chunk.hpp"
+#include <cassert>
+#include <cstdlib>
+
+namespace qwy2
+{
+
+template<typename ComponentType>
+ChunkComponentGrid<ComponentType>::Iterator::Iterator(
+	ChunkComponentGrid* grid, unsigned int slot_index
+):
+	grid{grid}, slot_index{slot_index}
+{
+	;
+}
+
+template<typename ComponentType>
+typename ChunkComponentGrid<ComponentType>::Entry&
+	ChunkComponentGrid<ComponentType>::Iterator::operator*() const
+{
+	return *this->grid->entry_at(this->slot_index);
+}
+
+template<typename ComponentType>
+typename ChunkComponentGrid<ComponentType>::Entry*
+	ChunkComponentGrid<ComponentType>::Iterator::operator->() const
+{
+	return &*this->grid->entry_at(this->slot_index);
+}
+
+template<typename ComponentType>
+typename ChunkComponentGrid<ComponentType>::Iterator&
+	ChunkComponentGrid<ComponentType>::Iterator::operator++()
+{
+	this->slot_index = this->grid->next_occupied_slot(this->slot_index + 1);
+	return *this;
+}
+
+template<typename ComponentType>
+bool ChunkComponentGrid<ComponentType>::Iterator::operator==(Iterator const& right) const
+{
+	return this->slot_index == right.slot_index;
+}
+
+template<typename ComponentType>
+bool ChunkComponentGrid<ComponentType>::Iterator::operator!=(Iterator const& right) const
+{
+	return not (*this == right);
+}
+
+template<typename ComponentType>
+ChunkComponentGrid<ComponentType>::ConstIterator::ConstIterator(
+	ChunkComponentGrid const* grid, unsigned int slot_index
+):
+	grid{grid}, slot_index{slot_index}
+{
+	;
+}
+
+template<typename ComponentType>
+typename ChunkComponentGrid<ComponentType>::Entry const&
+	ChunkComponentGrid<ComponentType>::ConstIterator::operator*() const
+{
+	return *this->grid->entry_at(this->slot_index);
+}
+
+template<typename ComponentType>
+typename ChunkComponentGrid<ComponentType>::Entry const*
+	ChunkComponentGrid<ComponentType>::ConstIterator::operator->() const
+{
+	return &*this->grid->entry_at(this->slot_index);
+}
+
+template<typename ComponentType>
+typename ChunkComponentGrid<ComponentType>::ConstIterator&
+	ChunkComponentGrid<ComponentType>::ConstIterator::operator++()
+{
+	this->slot_index = this->grid->next_occupied_slot(this->slot_index + 1);
+	return *this;
+}
+
+template<typename ComponentType>
+bool ChunkComponentGrid<ComponentType>::ConstIterator::operator==(
+	ConstIterator const& right) const
+{
+	return this->slot_index == right.slot_index;
+}
+
+template<typename ComponentType>
+bool ChunkComponentGrid<ComponentType>::ConstIterator::operator!=(
+	ConstIterator const& right) const
+{
+	return not (*this == right);
+}
+
+template<typename ComponentType>
+ChunkComponentGrid<ComponentType>::ChunkComponentGrid():
+	ring_side{0},
+	occupied_count{0},
+	removed_count{0},
+	ring_occupied_count{0}
+{
+	;
+}
+
+template<typename ComponentType>
+void ChunkComponentGrid<ComponentType>::use_ring_buffer(unsigned int ring_side)
+{
+	assert(this->empty());
+	this->ring_side = ring_side;
+	unsigned int const ring_volume = ring_side * ring_side * ring_side;
+	this->ring_slot_table.assign(ring_volume, Slot{ChunkCoords{0, 0, 0}, SlotState::EMPTY});
+	this->ring_entry_table.clear();
+	this->ring_entry_table.resize(ring_volume);
+}
+
+template<typename ComponentType>
+unsigned int ChunkComponentGrid<ComponentType>::size() const
+{
+	return this->ring_occupied_count + this->occupied_count;
+}
+
+template<typename ComponentType>
+bool ChunkComponentGrid<ComponentType>::empty() const
+{
+	return this->size() == 0;
+}
+
+template<typename ComponentType>
+typename ChunkComponentGrid<ComponentType>::Iterator ChunkComponentGrid<ComponentType>::begin()
+{
+	return Iterator{this, this->next_occupied_slot(0)};
+}
+
+template<typename ComponentType>
+typename ChunkComponentGrid<ComponentType>::Iterator ChunkComponentGrid<ComponentType>::end()
+{
+	return Iterator{this, this->end_slot_index()};
+}
+
+template<typename ComponentType>
+typename ChunkComponentGrid<ComponentType>::ConstIterator
+	ChunkComponentGrid<ComponentType>::begin() const
+{
+	return ConstIterator{this, this->next_occupied_slot(0)};
+}
+
+template<typename ComponentType>
+typename ChunkComponentGrid<ComponentType>::ConstIterator
+	ChunkComponentGrid<ComponentType>::end() const
+{
+	return ConstIterator{this, this->end_slot_index()};
+}
+
+template<typename ComponentType>
+typename ChunkComponentGrid<ComponentType>::Iterator
+	ChunkComponentGrid<ComponentType>::find(ChunkCoords chunk_coords)
+{
+	return Iterator{this, this->find_slot(chunk_coords)};
+}
+
+template<typename ComponentType>
+typename ChunkComponentGrid<ComponentType>::ConstIterator
+	ChunkComponentGrid<ComponentType>::find(ChunkCoords chunk_coords) const
+{
+	return ConstIterator{this, this->find_slot(chunk_coords)};
+}
+
+template<typename ComponentType>
+ComponentType& ChunkComponentGrid<ComponentType>::at(ChunkCoords chunk_coords)
+{
+	unsigned int const slot_index = this->find_slot(chunk_coords);
+	if (slot_index == this->end_slot_index())
+	{
+		assert(false /* There is no component at the given chunk coords. */);
+		std::exit(EXIT_FAILURE);
+	}
+	return this->entry_at(slot_index)->second;
+}
+
+template<typename ComponentType>
+ComponentType const& ChunkComponentGrid<ComponentType>::at(ChunkCoords chunk_coords) const
+{
+	unsigned int const slot_index = this->find_slot(chunk_coords);
+	if (slot_index == this->end_slot_index())
+	{
+		assert(false /* There is no component at the given chunk coords. */);
+		std::exit(EXIT_FAILURE);
+	}
+	return this->entry_at(slot_index)->second;
+}
+
+template<typename ComponentType>
+std::pair<typename ChunkComponentGrid<ComponentType>::Iterator, bool>
+	ChunkComponentGrid<ComponentType>::insert(Entry entry)
+{
+	return this->emplace(entry.first, std::move(entry.second));
+}
+
+template<typename ComponentType>
+std::pair<typename ChunkComponentGrid<ComponentType>::Iterator, bool>
+	ChunkComponentGrid<ComponentType>::insert_or_assign(
+		ChunkCoords chunk_coords, ComponentType component)
+{
+	auto const [iterator, inserted] = this->emplace(chunk_coords, std::move(component));
+	if (not inserted)
+	{
+		iterator->second = std::move(component);
+	}
+	return std::make_pair(iterator, inserted);
+}
+
+template<typename ComponentType>
+unsigned int ChunkComponentGrid<ComponentType>::erase(ChunkCoords chunk_coords)
+{
+	Iterator const iterator = this->find(chunk_coords);
+	if (iterator == this->end())
+	{
+		return 0;
+	}
+	this->erase(iterator);
+	return 1;
+}
+
+template<typename ComponentType>
+typename ChunkComponentGrid<ComponentType>::Iterator
+	ChunkComponentGrid<ComponentType>::erase(Iterator iterator)
+{
+	Slot& slot = this->slot_at(iterator.slot_index);
+	assert(slot.state == SlotState::OCCUPIED);
+	if (iterator.slot_index < this->ring_volume())
+	{
+		slot.state = SlotState::EMPTY;
+		this->ring_occupied_count--;
+	}
+	else
+	{
+		slot.state = SlotState::REMOVED;
+		this->occupied_count--;
+		this->removed_count++;
+	}
+	this->entry_at(iterator.slot_index).reset();
+	return ++iterator;
+}
+
+template<typename ComponentType>
+void ChunkComponentGrid<ComponentType>::clear()
+{
+	for (unsigned int i = 0; i < this->ring_volume(); i++)
+	{
+		this->ring_slot_table[i].state = SlotState::EMPTY;
+		this->ring_entry_table[i].reset();
+	}
+	this->ring_occupied_count = 0;
+	this->slot_table.clear();
+	this->entry_table.clear();
+	this->occupied_count = 0;
+	this->removed_count = 0;
+}
+
+template<typename ComponentType>
+unsigned int ChunkComponentGrid<ComponentType>::ring_volume() const
+{
+	return this->ring_slot_table.size();
+}
+
+template<typename ComponentType>
+unsigned int ChunkComponentGrid<ComponentType>::end_slot_index() const
+{
+	return this->ring_slot_table.size() + this->slot_table.size();
+}
+
+template<typename ComponentType>
+typename ChunkComponentGrid<ComponentType>::Slot&
+	ChunkComponentGrid<ComponentType>::slot_at(unsigned int slot_index)
+{
+	unsigned int const ring_volume = this->ring_volume();
+	return slot_index < ring_volume ?
+		this->ring_slot_table[slot_index] :
+		this->slot_table[slot_index - ring_volume];
+}
+
+template<typename ComponentType>
+std::optional<typename ChunkComponentGrid<ComponentType>::Entry>&
+	ChunkComponentGrid<ComponentType>::entry_at(unsigned int slot_index)
+{
+	unsigned int const ring_volume = this->ring_volume();
+	return slot_index < ring_volume ?
+		this->ring_entry_table[slot_index] :
+		this->entry_table[slot_index - ring_volume];
+}
+
+template<typename ComponentType>
+std::optional<typename ChunkComponentGrid<ComponentType>::Entry> const&
+	ChunkComponentGrid<ComponentType>::entry_at(unsigned int slot_index) const
+{
+	unsigned int const ring_volume = this->ring_volume();
+	return slot_index < ring_volume ?
+		this->ring_entry_table[slot_index] :
+		this->entry_table[slot_index - ring_volume];
+}
+
+namespace
+{
+
+/* Modulo that is never negative (unlike the `%` operator with a negative left operand). */
+unsigned int positive_modulo(int value, unsigned int modulus)
+{
+	int const remainder = value % static_cast<int>(modulus);
+	return remainder < 0 ? remainder + modulus : remainder;
+}
+
+} /* Anonymous namespace. */
+
+template<typename ComponentType>
+unsigned int ChunkComponentGrid<ComponentType>::ring_slot_index(ChunkCoords chunk_coords) const
+{
+	unsigned int const side = this->ring_side;
+	return
+		positive_modulo(chunk_coords.x, side) +
+		positive_modulo(chunk_coords.y, side) * side +
+		positive_modulo(chunk_coords.z, side) * side * side;
+}
+
+template<typename ComponentType>
+std::pair<unsigned int, bool> ChunkComponentGrid<ComponentType>::find_or_prepare_slot(
+	ChunkCoords chunk_coords)
+{
+	/* The chunk may be in the hash table even if its ring buffer slot is free,
+	 * if it was inserted while its ring buffer slot was taken. */
+	std::optional<unsigned int> free_ring_slot_index;
+	if (this->ring_side != 0)
+	{
+		unsigned int const ring_slot_index = this->ring_slot_index(chunk_coords);
+		Slot const& ring_slot = this->ring_slot_table[ring_slot_index];
+		if (ring_slot.state == SlotState::OCCUPIED)
+		{
+			if (ring_slot.chunk_coords == chunk_coords)
+			{
+				return std::make_pair(ring_slot_index, true);
+			}
+		}
+		else
+		{
+			free_ring_slot_index = ring_slot_index;
+		}
+	}
+	if (this->occupied_count != 0)
+	{
+		unsigned int const slot_index = this->find_hash_slot(chunk_coords);
+		if (slot_index != this->end_slot_index())
+		{
+			return std::make_pair(slot_index, true);
+		}
+	}
+	if (free_ring_slot_index.has_value())
+	{
+		return std::make_pair(free_ring_slot_index.value(), false);
+	}
+
+	/* The load factor (counting the tombstones as they also lengthen the probe sequences)
+	 * is kept under 3/4. If the tombstones make for most of the load then the table is
+	 * just cleaned of them, else it is grown. */
+	unsigned int const slot_count = this->slot_table.size();
+	if ((this->occupied_count + this->removed_count + 1) * 4 > slot_count * 3)
+	{
+		this->rehash(
+			slot_count == 0 ? 16 :
+			(this->occupied_count + 1) * 2 > slot_count ? slot_count * 2 :
+			slot_count);
+	}
+
+	/* The chunk is not there, it goes in the first free slot of its probe sequence. */
+	unsigned int const mask = this->slot_table.size() - 1;
+	unsigned int slot_index = ChunkCoords::Hash{}(chunk_coords) & mask;
+	while (this->slot_table[slot_index].state == SlotState::OCCUPIED)
+	{
+		slot_index = (slot_index + 1) & mask;
+	}
+	return std::make_pair(this->ring_volume() + slot_index, false);
+}
+
+template<typename ComponentType>
+unsigned int ChunkComponentGrid<ComponentType>::find_slot(ChunkCoords chunk_coords) const
+{
+	if (this->ring_side != 0)
+	{
+		unsigned int const ring_slot_index = this->ring_slot_index(chunk_coords);
+		Slot const& ring_slot = this->ring_slot_table[ring_slot_index];
+		if (ring_slot.state == SlotState::OCCUPIED && ring_slot.chunk_coords == chunk_coords)
+		{
+			return ring_slot_index;
+		}
+	}
+	if (this->occupied_count == 0)
+	{
+		return this->end_slot_index();
+	}
+	return this->find_hash_slot(chunk_coords);
+}
+
+template<typename ComponentType>
+unsigned int ChunkComponentGrid<ComponentType>::find_hash_slot(ChunkCoords chunk_coords) const
+{
+	unsigned int const mask = this->slot_table.size() - 1;
+	unsigned int slot_index = ChunkCoords::Hash{}(chunk_coords) & mask;
+	while (true)
+	{
+		Slot const& slot = this->slot_table[slot_index];
+		if (slot.state == SlotState::EMPTY)
+		{
+			return this->end_slot_index();
+		}
+		else if (slot.state == SlotState::OCCUPIED && slot.chunk_coords == chunk_coords)
+		{
+			return this->ring_volume() + slot_index;
+		}
+		slot_index = (slot_index + 1) & mask;
+	}
+}
+
+template<typename ComponentType>
+unsigned int ChunkComponentGrid<ComponentType>::next_occupied_slot(unsigned int slot_index) const
+{
+	unsigned int const ring_volume = this->ring_volume();
+	while (slot_index < ring_volume)
+	{
+		if (this->ring_slot_table[slot_index].state == SlotState::OCCUPIED)
+		{
+			return slot_index;
+		}
+		slot_index++;
+	}
+	unsigned int const end_slot_index = this->end_slot_index();
+	while (slot_index < end_slot_index &&
+		this->slot_table[slot_index - ring_volume].state != SlotState::OCCUPIED)
+	{
+		slot_index++;
+	}
+	return slot_index;
+}
+
+template<typename ComponentType>
+void ChunkComponentGrid<ComponentType>::rehash(unsigned int slot_count)
+{
+	assert((slot_count & (slot_count - 1)) == 0);
+	assert(this->occupied_count < slot_count);
+	std::vector<Slot> old_slot_table = std::move(this->slot_table);
+	std::vector<std::optional<Entry>> old_entry_table = std::move(this->entry_table);
+	this->slot_table.assign(slot_count, Slot{ChunkCoords{0, 0, 0}, SlotState::EMPTY});
+	this->entry_table.clear();
+	this->entry_table.resize(slot_count);
+	this->removed_count = 0;
+
+	unsigned int const mask = slot_count - 1;
+	for (unsigned int i = 0; i < old_slot_table.size(); i++)
+	{
+		if (old_slot_table[i].state != SlotState::OCCUPIED)
+		{
+			continue;
+		}
+		ChunkCoords const chunk_coords = old_slot_table[i].chunk_coords;
+		unsigned int slot_index = ChunkCoords::Hash{}(chunk_coords) & mask;
+		while (this->slot_table[slot_index].state != SlotState::EMPTY)
+		{
+			slot_index = (slot_index + 1) & mask;
+		}
+		this->slot_table[slot_index] = Slot{chunk_coords, SlotState::OCCUPIED};
+		this->entry_table[slot_index] = std::move(old_entry_table[i]);
+	}
+}
+
+template class ChunkComponentGrid<ChunkPtgField>;
+template class ChunkComponentGrid<ChunkPttField>;
+template class ChunkComponentGrid<ChunkBField>;
+template class ChunkComponentGrid<Mesh<VertexDataChunk>>;
+template class ChunkComponentGrid<ChunkMeshBlockTable>;
+template class ChunkComponentGrid<ChunkEntityTable>;
+template class ChunkComponentGrid<ChunkDiskStorage>;
+template class ChunkComponentGrid<std::chrono::high_resolution_clock::time_point>;
+template class ChunkComponentGrid<ChunkRemeshingData>;
+
+} /* qwy2 */
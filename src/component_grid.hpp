@@ -0,0 +1,207 @@
+
+#ifndef QWY2_HEADER_COMPONENT_GRID_
+#define QWY2_HEADER_COMPONENT_GRID_
+
+#include "coords.hpp"
+#include <vector>
+#include <optional>
+#include <utility>
+#include <cstdint>
+
+namespace qwy2
+{
+
+/* Map from chunk coords to some component of the chunks (a field, a mesh, etc.).
+ * It is a hash table with open addressing and linear probing: the coords of the chunks are
+ * packed in an array of slots that a lookup reads contiguously (the components being kept
+ * in a parallel array so that they do not get in the way), which is faster than chasing
+ * the nodes of an `std::unordered_map` when there are a lot of lookups (such as the 27 done
+ * to get a neighborhood of fields).
+ * It provides the part of the `std::unordered_map` interface that the chunk grid uses.
+ * Erasing an entry leaves a tombstone in its slot, so erasing never moves anything and
+ * never invalidates the iterators to the other entries (which allows to erase while
+ * iterating). However, inserting may rehash the table which moves all the components
+ * and invalidates all the iterators and references to them (unlike `std::unordered_map`
+ * that keeps the references valid).
+ * Optionally (see `use_ring_buffer`), the grid can also have a ring buffer: a 3D array of
+ * slots in which a chunk has its slot at its coords modulo the side of the array, so that
+ * a lookup is just one array access. The loaded chunks form a ball around the player,
+ * so if the ring buffer is big enough to contain that ball then each loaded chunk has its
+ * slot to itself (and the slot of an unloaded chunk gets reused by the chunk that gets
+ * loaded on the other side of the ball as the player moves). Each slot holds the coords of
+ * the chunk that is in it, and a chunk that finds its slot taken by an other chunk goes in
+ * the hash table instead (so that the ring buffer never has to be big enough, it just
+ * should be for lookups to be fast). */
+template<typename ComponentType>
+class ChunkComponentGrid
+{
+public:
+	using Entry = std::pair<ChunkCoords, ComponentType>;
+
+private:
+	enum class SlotState: std::uint8_t
+	{
+		EMPTY,
+		OCCUPIED,
+		/* Tombstone of an erased entry, lookups must probe past it. */
+		REMOVED,
+	};
+
+	class Slot
+	{
+	public:
+		ChunkCoords chunk_coords;
+		SlotState state;
+	};
+
+	/* The side of the ring buffer (0 if there is none). */
+	unsigned int ring_side;
+	/* Indexed as `ring_slot_table`, the slots of the ring buffer are never `REMOVED`. */
+	std::vector<Slot> ring_slot_table;
+	std::vector<std::optional<Entry>> ring_entry_table;
+
+	/* Indexed as `slot_table` (its length is 0 or a power of 2). */
+	std::vector<Slot> slot_table;
+	std::vector<std::optional<Entry>> entry_table;
+	/* In the hash table only. */
+	unsigned int occupied_count;
+	unsigned int removed_count;
+	/* In the ring buffer only. */
+	unsigned int ring_occupied_count;
+
+public:
+	class Iterator
+	{
+	private:
+		ChunkComponentGrid* grid;
+		unsigned int slot_index;
+
+	public:
+		Iterator(ChunkComponentGrid* grid, unsigned int slot_index);
+		Entry& operator*() const;
+		Entry* operator->() const;
+		Iterator& operator++();
+		bool operator==(Iterator const& right) const;
+		bool operator!=(Iterator const& right) const;
+
+		friend class ChunkComponentGrid;
+	};
+
+	class ConstIterator
+	{
+	private:
+		ChunkComponentGrid const* grid;
+		unsigned int slot_index;
+
+	public:
+		ConstIterator(ChunkComponentGrid const* grid, unsigned int slot_index);
+		Entry const& operator*() const;
+		Entry const* operator->() const;
+		ConstIterator& operator++();
+		bool operator==(ConstIterator const& right) const;
+		bool operator!=(ConstIterator const& right) const;
+	};
+
+public:
+	ChunkComponentGrid();
+
+	/* Gives a ring buffer of the given side to the grid, that must be empty.
+	 * Chunks that are less than the given side apart along each axis never share a slot. */
+	void use_ring_buffer(unsigned int ring_side);
+
+	unsigned int size() const;
+	bool empty() const;
+
+	Iterator begin();
+	Iterator end();
+	ConstIterator begin() const;
+	ConstIterator end() const;
+
+	Iterator find(ChunkCoords chunk_coords);
+	ConstIterator find(ChunkCoords chunk_coords) const;
+
+	/* The component must be there. */
+	ComponentType& at(ChunkCoords chunk_coords);
+	ComponentType const& at(ChunkCoords chunk_coords) const;
+
+	/* Does nothing if there already is a component at the given coords
+	 * (the returned bool tells if the insertion took place). */
+	std::pair<Iterator, bool> insert(Entry entry);
+	template<typename... ArgTypes>
+	std::pair<Iterator, bool> emplace(ChunkCoords chunk_coords, ArgTypes&&... args);
+
+	/* Replaces the component if there already is one at the given coords. */
+	std::pair<Iterator, bool> insert_or_assign(ChunkCoords chunk_coords,
+		ComponentType component);
+
+	/* Returns the number of erased components (0 or 1). */
+	unsigned int erase(ChunkCoords chunk_coords);
+	/* Returns an iterator to the entry that follows the erased one. */
+	Iterator erase(Iterator iterator);
+
+	void clear();
+
+private:
+	/* The slots of the ring buffer come first in the indexing of the slots used by
+	 * the iterators, followed by the slots of the hash table. */
+	unsigned int ring_volume() const;
+	unsigned int end_slot_index() const;
+	Slot& slot_at(unsigned int slot_index);
+	std::optional<Entry>& entry_at(unsigned int slot_index);
+	std::optional<Entry> const& entry_at(unsigned int slot_index) const;
+
+	/* Returns the index of the slot of the ring buffer in which the given chunk would be. */
+	unsigned int ring_slot_index(ChunkCoords chunk_coords) const;
+
+	/* Returns the index of the slot of the given coords, or of the slot where they should
+	 * be inserted (the returned bool tells if they are already there). The hash table is
+	 * grown or cleaned of its tombstones beforehand if needed, so that one more entry fits. */
+	std::pair<unsigned int, bool> find_or_prepare_slot(ChunkCoords chunk_coords);
+
+	/* Returns the index of the slot of the given coords, or `end_slot_index()`
+	 * (which is the index of `end()`) if they are not there. */
+	unsigned int find_slot(ChunkCoords chunk_coords) const;
+
+	/* Same as `find_slot` but only in the hash table. */
+	unsigned int find_hash_slot(ChunkCoords chunk_coords) const;
+
+	/* Returns the index of the first occupied slot starting at the given index,
+	 * or `end_slot_index()` if there is none. */
+	unsigned int next_occupied_slot(unsigned int slot_index) const;
+
+	/* Reinserts all the entries into a table of the given number of slots
+	 * (a power of 2), which gets rid of all the tombstones. */
+	void rehash(unsigned int slot_count);
+};
+
+template<typename ComponentType>
+template<typename... ArgTypes>
+std::pair<typename ChunkComponentGrid<ComponentType>::Iterator, bool>
+	ChunkComponentGrid<ComponentType>::emplace(ChunkCoords chunk_coords, ArgTypes&&... args)
+{
+	auto const [slot_index, found] = this->find_or_prepare_slot(chunk_coords);
+	if (not found)
+	{
+		Slot& slot = this->slot_at(slot_index);
+		if (slot_index < this->ring_volume())
+		{
+			this->ring_occupied_count++;
+		}
+		else
+		{
+			if (slot.state == SlotState::REMOVED)
+			{
+				this->removed_count--;
+			}
+			this->occupied_count++;
+		}
+		slot = Slot{chunk_coords, SlotState::OCCUPIED};
+		this->entry_at(slot_index).emplace(chunk_coords,
+			ComponentType(std::forward<ArgTypes>(args)...));
+	}
+	return std::make_pair(Iterator{this, slot_index}, not found);
+}
+
+} /* qwy2 */
+
+#endif /* QWY2_HEADER_COMPONENT_GRID_ */
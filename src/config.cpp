@@ -62,7 +62,9 @@ Config::Config()
 	 * (I'm pretty sure I had a good reason when that decision was taken).
 	 * This parameter has a big impact on the performances, some values are *significantly*
 	 * better than others, and the best value probably depends on the machine.
-	 * Beware setting this to too small or too big values can cause lag issues. */
+	 * Beware setting this to too small or too big values can cause lag issues.
+	 * The chunk generation code is specialized for the values 15, 25, 31 and 33,
+	 * other values go through a slower generic path. */
 	this->parameter_table.insert({"chunk_side"sv, 25});
 	this->corrector_table.insert({"chunk_side"sv, [](ParameterType& variant_value){
 		int const value = std::get<int>(variant_value);
@@ -74,6 +76,15 @@ Config::Config()
 				<< std::endl;
 			return false;
 		}
+		if (value > 255)
+		{
+			/* Chunk mesh vertices have 8-bit chunk-local coords, see `VertexDataChunk`. */
+			std::cout << "\x1b[31mCommand line error:\x1b[39m "
+				<< "The chunk_side value should be at most 255, "
+				<< "thus " << value << " is not valid."
+				<< std::endl;
+			return false;
+		}
 		if (value % 2 == 0)
 		{
 			std::cout << "\x1b[31mCommand line error:\x1b[39m "
@@ -85,6 +96,27 @@ Config::Config()
 		return true;
 	}});
 
+	/* If true, then the PTT field generation and the meshing of a chunk first copy the blocks
+	 * they need from the neighboring chunks into one contiguous buffer, which makes the reads
+	 * way cheaper. If false, then they read directly from the fields of the neighboring chunks.
+	 * The benchmark mode measures both ways. */
+	this->parameter_table.insert({"padded_neighborhoods"sv, true});
+
+	/* If true, then the chunk meshes are generated by merging the faces that look the same
+	 * into bigger quads, which makes for way smaller meshes. */
+	this->parameter_table.insert({"greedy_meshing"sv, false});
+
+	/* If true, then the chunk grid finds the chunks that are around the player via ring buffers
+	 * (big enough to contain the unloading distance) instead of hash tables only, which makes
+	 * lookups cheaper but costs a slot in each ring buffer for each chunk that could be loaded.
+	 * The benchmark mode measures both ways. */
+	this->parameter_table.insert({"chunk_grid_ring_buffer"sv, false});
+
+	/* If true, then the saved chunks are read from the region files via memory mappings
+	 * of the files instead of file reads, so that loading a saved chunk costs page faults
+	 * (or nothing if its pages are still in memory) instead of syscalls and copies. */
+	this->parameter_table.insert({"mmap_region_files"sv, true});
+
 	/* Seed of the whole nature and world generation. */
 	this->parameter_table.insert({"seed"sv, 9});
 
@@ -103,6 +135,70 @@ Config::Config()
 		return true;
 	}});
 
+	/* The maximum number of chunk generation steps that can be undergoing at the same time.
+	 * A few more than the number of loading threads keeps them busy without making the
+	 * generation order too stale. If 0, then it is the number of loading threads plus 2. */
+	this->parameter_table.insert({"max_generation_tasks"sv, 0});
+	this->corrector_table.insert({"max_generation_tasks"sv, [](ParameterType& variant_value){
+		int const value = std::get<int>(variant_value);
+		if (value < 0)
+		{
+			std::cout << "\x1b[31mCommand line error:\x1b[39m "
+				<< "The max_generation_tasks value should be positive, "
+				<< "thus " << value << " is not valid."
+				<< std::endl;
+			return false;
+		}
+		return true;
+	}});
+
+	/* Weights that make the chunk generation prioritize some chunks over closer chunks.
+	 * A chunk is prioritized as if its distance to the player was divided by 1 plus the sum
+	 * of the weights that apply to it, so all at 0 means that the closest chunks come first.
+	 * The view weight applies to chunks in the view of the player camera, the motion weight
+	 * applies to chunks in the direction the player is moving towards (scaled by how aligned
+	 * they are), and the falling weight applies to chunks below a falling player.
+	 * For example 2 makes a chunk 3 times as far away be as prioritized. */
+	this->parameter_table.insert({"generation_priority_view"sv, 0.0f});
+	this->corrector_table.insert({"generation_priority_view"sv, [](ParameterType& variant_value){
+		float const value = std::get<float>(variant_value);
+		if (value < 0.0f)
+		{
+			std::cout << "\x1b[31mCommand line error:\x1b[39m "
+				<< "The generation_priority_view value should be positive (or zero), "
+				<< "thus " << value << " is not valid."
+				<< std::endl;
+			return false;
+		}
+		return true;
+	}});
+	this->parameter_table.insert({"generation_priority_motion"sv, 0.0f});
+	this->corrector_table.insert({"generation_priority_motion"sv, [](ParameterType& variant_value){
+		float const value = std::get<float>(variant_value);
+		if (value < 0.0f)
+		{
+			std::cout << "\x1b[31mCommand line error:\x1b[39m "
+				<< "The generation_priority_motion value should be positive (or zero), "
+				<< "thus " << value << " is not valid."
+				<< std::endl;
+			return false;
+		}
+		return true;
+	}});
+	this->parameter_table.insert({"generation_priority_falling"sv, 0.0f});
+	this->corrector_table.insert({"generation_priority_falling"sv, [](ParameterType& variant_value){
+		float const value = std::get<float>(variant_value);
+		if (value < 0.0f)
+		{
+			std::cout << "\x1b[31mCommand line error:\x1b[39m "
+				<< "The generation_priority_falling value should be positive (or zero), "
+				<< "thus " << value << " is not valid."
+				<< std::endl;
+			return false;
+		}
+		return true;
+	}});
+
 	/* The length (in pixels) of the side of the square-shaped framebuffer in which
 	 * the shadow map (shadows cast by the sun) is stored.
 	 * Less means faster rendering but also more pixelated shadows.
@@ -237,6 +333,31 @@ Config::Config()
 
 	/* Camera (which uses a perspective projection) FOV (Field Of View) value. */
 	this->parameter_table.insert({"fovy"sv, TAU / 6.0f});
+
+	/* If true, then instead of running the game, the chunk generation pipeline is benchmarked
+	 * (without any window nor OpenGL context) and the results are printed. */
+	this->parameter_table.insert({"benchmark"sv, false});
+
+	/* The radius (in chunks, the center chunk counting as one) of the cube of chunks that get
+	 * to be meshed by the benchmark, the earlier steps are also performed on the bigger cubes
+	 * of chunks that they require. */
+	this->parameter_table.insert({"benchmark_radius"sv, 2});
+	this->corrector_table.insert({"benchmark_radius"sv, [](ParameterType& variant_value){
+		int const value = std::get<int>(variant_value);
+		if (value <= 0)
+		{
+			std::cout << "\x1b[31mCommand line error:\x1b[39m "
+				<< "The benchmark_radius value should be strictly positive, "
+				<< "thus " << value << " is not valid."
+				<< std::endl;
+			return false;
+		}
+		return true;
+	}});
+
+	/* If true, then the benchmark is run once for every built-in plain terrain generator,
+	 * else it is only run for the one given by `terrain_generator`. */
+	this->parameter_table.insert({"benchmark_all_terrain_generators"sv, true});
 }
 
 ErrorCode Config::parse_command_line(int argc, char const* const* argv)
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 
 namespace qwy2
 {
@@ -94,10 +95,19 @@ bool CoordsInt<L>::is_common_face_neighbor(CoordsInt other) const
 template<CoordsLevel L>
 std::size_t CoordsInt<L>::Hash::operator()(CoordsInt const& coords) const noexcept
 {
-	return
-		std::hash<int>()(coords.x ^ 10000) ^
-		std::hash<int>()(coords.y ^ 54678) ^
-		std::hash<int>()(coords.z ^ 22263);
+	/* `std::hash<int>` is the identity (with GCC), so just xoring the coords made for
+	 * a lot of collisions (such as all the permutations of some coords). Here each coord
+	 * is multiplied by a different big odd constant and the bits are then mixed up,
+	 * so that all the bits of the hash (the low ones used by hash tables in particular)
+	 * depend on all the bits of the coords. */
+	std::uint64_t hash =
+		static_cast<std::uint64_t>(static_cast<std::uint32_t>(coords.x)) * 0x9e3779b97f4a7c15u ^
+		static_cast<std::uint64_t>(static_cast<std::uint32_t>(coords.y)) * 0xc2b2ae3d27d4eb4fu ^
+		static_cast<std::uint64_t>(static_cast<std::uint32_t>(coords.z)) * 0x165667b19e3779f9u;
+	hash ^= hash >> 32;
+	hash *= 0xd6e8feb86659fd93u;
+	hash ^= hash >> 32;
+	return static_cast<std::size_t>(hash);
 }
 
 template class CoordsInt<CoordsLevel::BLOCK>;
@@ -62,7 +62,8 @@ public:
 
 public:
 	/* Callable hash that allows CoordsInt values to be used as keys
-	 * in std::unordered_map (that is implemented as a hash map). */
+	 * in std::unordered_map (that is implemented as a hash map)
+	 * and in `ChunkComponentGrid` (for chunk coords). */
 	class Hash
 	{
 	public:
@@ -9,6 +9,12 @@ extern char const g_shader_source_classic_vert[] = "\n#version 430 core\n\nlayou
 /* Content of "src/shaders/classic/classic.frag". */
 extern char const g_shader_source_classic_frag[] = "\n#version 430 core\n\nin vec2 v_atlas_coords;\nin vec2 v_atlas_coords_min;\nin vec2 v_atlas_coords_max;\nin vec3 v_normal;\nin vec3 v_sun_camera_space_coords;\nin vec3 v_coords;\nin float v_ambient_occlusion;\n\nlayout(location =  1) uniform sampler2D u_atlas;\nlayout(location =  6) uniform float u_atlas_side;\nlayout(location =  3) uniform sampler2D u_shadow_depth;\nlayout(location =  4) uniform vec3 u_sun_camera_direction;\nlayout(location =  7) uniform vec3 u_user_coords;\nlayout(location =  8) uniform vec3 u_fog_color;\nlayout(location =  9) uniform float u_fog_distance_inf;\nlayout(location = 10) uniform float u_fog_distance_sup;\n\nout vec4 out_color;\n\nvoid main()\n{\n\t/* Clamp atlas coords in the assigned texture to stop bleeding. */\n\t/* TODO: Do it in the mesh construction! Is it possible tho ? */\n\tconst float texel_side = (1.0 / u_atlas_side) / 2.0;\n\tconst vec2 atlas_coords = clamp(v_atlas_coords,\n\t\tv_atlas_coords_min + vec2(1.0, 1.0) * texel_side,\n\t\tv_atlas_coords_max - vec2(1.0, 1.0) * texel_side);\n\n\tout_color = texture(u_atlas, atlas_coords);\n\tif (out_color.a < 0.001)\n\t{\n\t\tdiscard;\n\t}\n\n\t/* Shadow calculation and effect. */\n\t/* TODO: Make `shadow_ratio` a parameter. */\n\t/* TODO: Make `ao_ratio_max` a parameter. */\n\tfloat light = -dot(v_normal, normalize(u_sun_camera_direction));\n\tconst float shadow_depth = texture(u_shadow_depth, v_sun_camera_space_coords.xy).r;\n\tconst bool is_in_shadow = v_sun_camera_space_coords.z > shadow_depth;\n\tif (is_in_shadow || light < 0.0)\n\t{\n\t\tlight *= 0.0;\n\t}\n\tconst float shadow_ratio = 0.7; /* How dark is it in the shadows. */\n\tout_color.rgb *= light * shadow_ratio + (1.0 - shadow_ratio);\n\tconst float ao_ratio_max = 0.7; /* How dark is it in corners (ambiant occlusion). */\n\tconst float ao_ratio = ao_ratio_max / (light + 1.0); \n\tout_color.rgb *= v_ambient_occlusion * ao_ratio + (1.0 - ao_ratio);\n\n\t/* Sun gold-ish color. */\n\t/* TODO: Make `sun_light_color` a parameter. */\n\tconst vec3 sun_light_color = vec3(0.5, 0.35, 0.0);\n\tout_color.rgb = mix(out_color.rgb,\n\t\tout_color.rgb * (vec3(1.0, 1.0, 1.0) + sun_light_color),\n\t\tlight);\n\n\t/* Fog effect. */\n\tconst float distance_to_user = distance(v_coords, u_user_coords);\n\t//const float fog_ratio =\n\t//\t(clamp(distance_to_user, u_fog_distance_inf, u_fog_distance_sup) - u_fog_distance_inf)\n\t//\t/ (u_fog_distance_sup - u_fog_distance_inf);\n\tconst float fog_ratio = smoothstep(u_fog_distance_inf, u_fog_distance_sup, distance_to_user);\n\tout_color.rgb = mix(out_color.rgb, u_fog_color, fog_ratio);\n}\n";
 
+/* Content of "src/shaders/chunk/chunk.vert". */
+extern char const g_shader_source_chunk_vert[] = "\n#version 430 core\n\nlayout(location = 0) in uint in_coords_face_ambient_occlusion;\nlayout(location = 1) in uint in_block_type_id;\n\nlayout(location = 0) uniform mat4 u_user_camera;\nlayout(location = 2) uniform mat4 u_sun_camera;\nlayout(location = 11) uniform vec3 u_chunk_origin_coords;\n\n/* The atlas rects have their min coords in xy and their max coords in zw. */\nstruct BlockTypeAtlasRects\n{\n\tvec4 top;\n\tvec4 vertical;\n\tvec4 bottom;\n};\nlayout(std430, binding = 0) readonly buffer BlockTypeTable\n{\n\tBlockTypeAtlasRects block_type_table[];\n};\n\nout vec2 v_atlas_coords;\nflat out vec2 v_atlas_coords_min;\nflat out vec2 v_atlas_coords_max;\nout vec3 v_normal;\nout vec3 v_sun_camera_space_coords;\nout vec3 v_coords;\nout float v_ambient_occlusion;\n\nvoid main()\n{\n\t/* Unpacking, see `VertexDataChunk`. */\n\tconst vec3 local_coords = vec3(\n\t\tfloat(in_coords_face_ambient_occlusion & 255u),\n\t\tfloat((in_coords_face_ambient_occlusion >> 8u) & 255u),\n\t\tfloat((in_coords_face_ambient_occlusion >> 16u) & 255u));\n\tconst uint face_id = (in_coords_face_ambient_occlusion >> 24u) & 7u;\n\tconst uint axis = face_id >> 1u;\n\tconst bool negativeward = (face_id & 1u) != 0u;\n\tconst uint ambient_occlusion = (in_coords_face_ambient_occlusion >> 27u) & 3u;\n\n\tconst vec3 coords = u_chunk_origin_coords + local_coords;\n\tgl_Position = u_user_camera * vec4(coords, 1.0);\n\n\t/* The atlas coords are given in faces, and the fragment shader only keeps their fractional\n\t * part (so that faces merged by greedy meshing repeat the texture). Some are negated\n\t * to get the textures to be oriented as expected on each face. */\n\tconst uint index_a = axis == 0u ? 1u : 0u;\n\tconst uint index_b = axis == 2u ? 1u : 2u;\n\tv_atlas_coords = vec2(local_coords[index_a], local_coords[index_b]);\n\tif ((axis == 1u && !negativeward) || (axis == 0u && negativeward))\n\t{\n\t\tv_atlas_coords.x = -v_atlas_coords.x;\n\t}\n\tif (axis == 0u || axis == 1u)\n\t{\n\t\tv_atlas_coords.y = -v_atlas_coords.y;\n\t}\n\tconst BlockTypeAtlasRects rects = block_type_table[in_block_type_id];\n\tconst vec4 rect = axis == 2u ? (negativeward ? rects.bottom : rects.top) : rects.vertical;\n\tv_atlas_coords_min = rect.xy;\n\tv_atlas_coords_max = rect.zw;\n\n\tv_normal = vec3(0.0, 0.0, 0.0);\n\tv_normal[axis] = negativeward ? -1.0 : 1.0;\n\n\t/* Coords of the vertex in the sun camera space,\n\t * and then in the shadow depth buffer space (0.0 ~ 1.0 instead of -1.0 ~ +1.0),\n\t * to compare the fragment depths to their shadow depth buffer analog. */\n\tvec4 sun_coords = u_sun_camera * vec4(coords, 1.0);\n\tv_sun_camera_space_coords = sun_coords.xyz / sun_coords.w;\n\tv_sun_camera_space_coords.xyz = (v_sun_camera_space_coords.xyz + 1.0) / 2.0;\n\n\tv_coords = coords;\n\n\tv_ambient_occlusion = float(ambient_occlusion) / 3.0;\n}\n";
+
+/* Content of "src/shaders/chunk/chunk.frag". */
+extern char const g_shader_source_chunk_frag[] = "\n#version 430 core\n\nin vec2 v_atlas_coords;\nflat in vec2 v_atlas_coords_min;\nflat in vec2 v_atlas_coords_max;\nin vec3 v_normal;\nin vec3 v_sun_camera_space_coords;\nin vec3 v_coords;\nin float v_ambient_occlusion;\n\nlayout(location =  1) uniform sampler2D u_atlas;\nlayout(location =  6) uniform float u_atlas_side;\nlayout(location =  3) uniform sampler2D u_shadow_depth;\nlayout(location =  4) uniform vec3 u_sun_camera_direction;\nlayout(location =  7) uniform vec3 u_user_coords;\nlayout(location =  8) uniform vec3 u_fog_color;\nlayout(location =  9) uniform float u_fog_distance_inf;\nlayout(location = 10) uniform float u_fog_distance_sup;\n\nout vec4 out_color;\n\nvoid main()\n{\n\t/* The atlas coords are in faces, see the vertex shader. */\n\tconst vec2 wrapped_atlas_coords =\n\t\tmix(v_atlas_coords_min, v_atlas_coords_max, fract(v_atlas_coords));\n\n\t/* Clamp atlas coords in the assigned texture to stop bleeding. */\n\t/* TODO: Do it in the mesh construction! Is it possible tho ? */\n\tconst float texel_side = (1.0 / u_atlas_side) / 2.0;\n\tconst vec2 atlas_coords = clamp(wrapped_atlas_coords,\n\t\tv_atlas_coords_min + vec2(1.0, 1.0) * texel_side,\n\t\tv_atlas_coords_max - vec2(1.0, 1.0) * texel_side);\n\n\tout_color = texture(u_atlas, atlas_coords);\n\tif (out_color.a < 0.001)\n\t{\n\t\tdiscard;\n\t}\n\n\t/* Shadow calculation and effect. */\n\t/* TODO: Make `shadow_ratio` a parameter. */\n\t/* TODO: Make `ao_ratio_max` a parameter. */\n\tfloat light = -dot(v_normal, normalize(u_sun_camera_direction));\n\tconst float shadow_depth = texture(u_shadow_depth, v_sun_camera_space_coords.xy).r;\n\tconst bool is_in_shadow = v_sun_camera_space_coords.z > shadow_depth;\n\tif (is_in_shadow || light < 0.0)\n\t{\n\t\tlight *= 0.0;\n\t}\n\tconst float shadow_ratio = 0.7; /* How dark is it in the shadows. */\n\tout_color.rgb *= light * shadow_ratio + (1.0 - shadow_ratio);\n\tconst float ao_ratio_max = 0.7; /* How dark is it in corners (ambiant occlusion). */\n\tconst float ao_ratio = ao_ratio_max / (light + 1.0); \n\tout_color.rgb *= v_ambient_occlusion * ao_ratio + (1.0 - ao_ratio);\n\n\t/* Sun gold-ish color. */\n\t/* TODO: Make `sun_light_color` a parameter. */\n\tconst vec3 sun_light_color = vec3(0.5, 0.35, 0.0);\n\tout_color.rgb = mix(out_color.rgb,\n\t\tout_color.rgb * (vec3(1.0, 1.0, 1.0) + sun_light_color),\n\t\tlight);\n\n\t/* Fog effect. */\n\tconst float distance_to_user = distance(v_coords, u_user_coords);\n\t//const float fog_ratio =\n\t//\t(clamp(distance_to_user, u_fog_distance_inf, u_fog_distance_sup) - u_fog_distance_inf)\n\t//\t/ (u_fog_distance_sup - u_fog_distance_inf);\n\tconst float fog_ratio = smoothstep(u_fog_distance_inf, u_fog_distance_sup, distance_to_user);\n\tout_color.rgb = mix(out_color.rgb, u_fog_color, fog_ratio);\n}\n";
+
 /* Content of "src/shaders/line/line.vert". */
 extern char const g_shader_source_line_vert[] = "\n#version 430 core\n\nlayout(location = 0) in vec3 in_coords;\nlayout(location = 1) in vec3 in_color;\n\nlayout(location = 0) uniform mat4 user_camera;\n\nout vec3 v_color;\n\nvoid main()\n{\n\tgl_Position = user_camera * vec4(in_coords, 1.0);\n\n\tv_color = in_color;\n}\n";
 
@@ -21,6 +27,12 @@ extern char const g_shader_source_shadow_vert[] = "\n#version 430 core\n\nlayout
 /* Content of "src/shaders/shadow/shadow.frag". */
 extern char const g_shader_source_shadow_frag[] = "\n#version 430 core\n\nin vec2 v_atlas_coords;\n\nlayout(location = 1) uniform sampler2D u_atlas;\n\nvoid main()\n{\n\t/* Here there is no need to carefully avoid atlas bleeding it seems. */\n\n\tvec4 out_color = texture(u_atlas, v_atlas_coords);\n\tif (out_color.a < 0.001)\n\t{\n\t\tdiscard;\n\t}\n\n\t/* We only checked for transparent `out_color`, but we then do nothing with it\n\t * as the only thing we care about is the Z-buffer. */\n}\n";
 
+/* Content of "src/shaders/chunk_shadow/chunk_shadow.vert". */
+extern char const g_shader_source_chunk_shadow_vert[] = "\n#version 430 core\n\nlayout(location = 0) in uint in_coords_face_ambient_occlusion;\nlayout(location = 1) in uint in_block_type_id;\n\nlayout(location = 0) uniform mat4 sun_camera;\nlayout(location = 2) uniform vec3 u_chunk_origin_coords;\n\n/* Same as in the chunk shader. */\nstruct BlockTypeAtlasRects\n{\n\tvec4 top;\n\tvec4 vertical;\n\tvec4 bottom;\n};\nlayout(std430, binding = 0) readonly buffer BlockTypeTable\n{\n\tBlockTypeAtlasRects block_type_table[];\n};\n\nout vec2 v_atlas_coords;\nflat out vec2 v_atlas_coords_min;\nflat out vec2 v_atlas_coords_max;\n\nvoid main()\n{\n\t/* Unpacking, see `VertexDataChunk` and the chunk shader. */\n\tconst vec3 local_coords = vec3(\n\t\tfloat(in_coords_face_ambient_occlusion & 255u),\n\t\tfloat((in_coords_face_ambient_occlusion >> 8u) & 255u),\n\t\tfloat((in_coords_face_ambient_occlusion >> 16u) & 255u));\n\tconst uint face_id = (in_coords_face_ambient_occlusion >> 24u) & 7u;\n\tconst uint axis = face_id >> 1u;\n\tconst bool negativeward = (face_id & 1u) != 0u;\n\n\tgl_Position = sun_camera * vec4(u_chunk_origin_coords + local_coords, 1.0);\n\n\tconst uint index_a = axis == 0u ? 1u : 0u;\n\tconst uint index_b = axis == 2u ? 1u : 2u;\n\tv_atlas_coords = vec2(local_coords[index_a], local_coords[index_b]);\n\tif ((axis == 1u && !negativeward) || (axis == 0u && negativeward))\n\t{\n\t\tv_atlas_coords.x = -v_atlas_coords.x;\n\t}\n\tif (axis == 0u || axis == 1u)\n\t{\n\t\tv_atlas_coords.y = -v_atlas_coords.y;\n\t}\n\tconst BlockTypeAtlasRects rects = block_type_table[in_block_type_id];\n\tconst vec4 rect = axis == 2u ? (negativeward ? rects.bottom : rects.top) : rects.vertical;\n\tv_atlas_coords_min = rect.xy;\n\tv_atlas_coords_max = rect.zw;\n}\n";
+
+/* Content of "src/shaders/chunk_shadow/chunk_shadow.frag". */
+extern char const g_shader_source_chunk_shadow_frag[] = "\n#version 430 core\n\nin vec2 v_atlas_coords;\nflat in vec2 v_atlas_coords_min;\nflat in vec2 v_atlas_coords_max;\n\nlayout(location = 1) uniform sampler2D u_atlas;\n\nvoid main()\n{\n\t/* Here there is no need to carefully avoid atlas bleeding it seems. */\n\n\tvec4 out_color = texture(u_atlas,\n\t\tmix(v_atlas_coords_min, v_atlas_coords_max, fract(v_atlas_coords)));\n\tif (out_color.a < 0.001)\n\t{\n\t\tdiscard;\n\t}\n\n\t/* We only checked for transparent `out_color`, but we then do nothing with it\n\t * as the only thing we care about is the Z-buffer. */\n}\n";
+
 /* Content of "src/shaders/simple/simple.vert". */
 extern char const g_shader_source_simple_vert[] = "\n#version 430 core\n\nlayout(location = 0) in vec3 in_coords;\nlayout(location = 1) in vec3 in_normal;\nlayout(location = 2) in vec3 in_color;\n\nlayout(location = 0) uniform mat4 u_user_camera;\nlayout(location = 5) uniform vec3 u_user_camera_direction;\nlayout(location = 2) uniform mat4 u_sun_camera;\n\nout vec3 v_normal;\nout vec3 v_sun_camera_space_coords;\nout vec3 v_coords;\nout vec3 v_color;\n\nvoid main()\n{\n\tgl_Position = u_user_camera * vec4(in_coords, 1.0);\n\n\tv_color = in_color;\n\n\tv_normal = in_normal;\n\t\n\t/* Coords of the vertex in the sun camera space,\n\t * and then in the shadow depth buffer space (0.0 ~ 1.0 instead of -1.0 ~ +1.0),\n\t * to compare the fragment depths to their shadow depth buffer analog. */\n\tvec4 sun_coords = u_sun_camera * vec4(in_coords, 1.0);\n\tv_sun_camera_space_coords = sun_coords.xyz / sun_coords.w; //uhu..\n\tv_sun_camera_space_coords.xyz = (v_sun_camera_space_coords.xyz + 1.0) / 2.0;\n\n\tv_coords = in_coords;\n}\n";
 
@@ -20,12 +20,18 @@
 EMBEDDED("shaders/classic/classic.vert", TEXT) char const g_shader_source_classic_vert[];
 EMBEDDED("shaders/classic/classic.frag", TEXT) char const g_shader_source_classic_frag[];
 
+EMBEDDED("shaders/chunk/chunk.vert", TEXT) char const g_shader_source_chunk_vert[];
+EMBEDDED("shaders/chunk/chunk.frag", TEXT) char const g_shader_source_chunk_frag[];
+
 EMBEDDED("shaders/line/line.vert", TEXT) char const g_shader_source_line_vert[];
 EMBEDDED("shaders/line/line.frag", TEXT) char const g_shader_source_line_frag[];
 
 EMBEDDED("shaders/shadow/shadow.vert", TEXT) char const g_shader_source_shadow_vert[];
 EMBEDDED("shaders/shadow/shadow.frag", TEXT) char const g_shader_source_shadow_frag[];
 
+EMBEDDED("shaders/chunk_shadow/chunk_shadow.vert", TEXT) char const g_shader_source_chunk_shadow_vert[];
+EMBEDDED("shaders/chunk_shadow/chunk_shadow.frag", TEXT) char const g_shader_source_chunk_shadow_frag[];
+
 EMBEDDED("shaders/simple/simple.vert", TEXT) char const g_shader_source_simple_vert[];
 EMBEDDED("shaders/simple/simple.frag", TEXT) char const g_shader_source_simple_frag[];
 
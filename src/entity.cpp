@@ -180,7 +180,8 @@ void Entity::apply_motion(float delta_time)
 	#endif
 
 	glm::vec3 motion_remaining = physics.motion * delta_time_in_60_fps_frames;
-	if (not chunk_grid.has_complete_mesh(containing_chunk_coords(this->coords)))
+	ChunkCoords const chunk_coords = chunk_grid.geometry.containing_chunk_coords(this->coords);
+	if (not chunk_grid.has_complete_mesh(chunk_coords))
 	{
 		/* Prevents falling through unloaded floor. */
 		motion_remaining.z = 0.0f;
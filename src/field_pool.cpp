@@ -0,0 +1,148 @@
+
+#include "field_pool.hpp"
+#include "chunk.hpp"
+#include <algorithm>
+
+namespace qwy2
+{
+
+template<typename ValueType>
+FieldBufferPool<ValueType>::ThreadCache::ThreadCache(FieldBufferPool* pool):
+	pool{pool}
+{
+	this->buffer_table.reserve(THREAD_CACHE_CAPACITY);
+}
+
+template<typename ValueType>
+FieldBufferPool<ValueType>::ThreadCache::~ThreadCache()
+{
+	std::lock_guard<std::mutex> lock{this->pool->free_buffer_mutex};
+	this->pool->free_buffer_table.insert(this->pool->free_buffer_table.end(),
+		this->buffer_table.begin(), this->buffer_table.end());
+}
+
+template<typename ValueType>
+FieldBufferPool<ValueType>::FieldBufferPool():
+	buffer_volume{0},
+	live_count{0},
+	free_count{0},
+	high_water_count{0}
+{
+	;
+}
+
+template<typename ValueType>
+FieldBufferPool<ValueType>::~FieldBufferPool()
+{
+	for (ValueType* buffer : this->free_buffer_table)
+	{
+		delete[] buffer;
+	}
+}
+
+template<typename ValueType>
+FieldBufferPool<ValueType>& FieldBufferPool<ValueType>::global()
+{
+	static FieldBufferPool pool;
+	return pool;
+}
+
+template<typename ValueType>
+ValueType* FieldBufferPool<ValueType>::acquire(unsigned int volume)
+{
+	if (not this->is_pooled_volume(volume))
+	{
+		return new ValueType[volume];
+	}
+
+	ThreadCache& cache = this->thread_cache();
+	if (cache.buffer_table.empty())
+	{
+		std::lock_guard<std::mutex> lock{this->free_buffer_mutex};
+		unsigned int const count = std::min<std::size_t>(
+			THREAD_CACHE_CAPACITY / 2, this->free_buffer_table.size());
+		cache.buffer_table.insert(cache.buffer_table.end(),
+			this->free_buffer_table.end() - count, this->free_buffer_table.end());
+		this->free_buffer_table.resize(this->free_buffer_table.size() - count);
+	}
+
+	ValueType* buffer;
+	if (cache.buffer_table.empty())
+	{
+		buffer = new ValueType[volume];
+	}
+	else
+	{
+		buffer = cache.buffer_table.back();
+		cache.buffer_table.pop_back();
+		this->free_count--;
+	}
+
+	unsigned int const live_count = ++this->live_count;
+	unsigned int high_water_count = this->high_water_count;
+	while (high_water_count < live_count &&
+		not this->high_water_count.compare_exchange_weak(high_water_count, live_count))
+	{
+		;
+	}
+	return buffer;
+}
+
+template<typename ValueType>
+void FieldBufferPool<ValueType>::release(ValueType* buffer, unsigned int volume)
+{
+	if (buffer == nullptr)
+	{
+		return;
+	}
+	else if (not this->is_pooled_volume(volume))
+	{
+		delete[] buffer;
+		return;
+	}
+
+	ThreadCache& cache = this->thread_cache();
+	cache.buffer_table.push_back(buffer);
+	this->live_count--;
+	this->free_count++;
+	if (cache.buffer_table.size() > THREAD_CACHE_CAPACITY)
+	{
+		std::lock_guard<std::mutex> lock{this->free_buffer_mutex};
+		unsigned int const count = cache.buffer_table.size() - THREAD_CACHE_CAPACITY / 2;
+		this->free_buffer_table.insert(this->free_buffer_table.end(),
+			cache.buffer_table.end() - count, cache.buffer_table.end());
+		cache.buffer_table.resize(cache.buffer_table.size() - count);
+	}
+}
+
+template<typename ValueType>
+FieldBufferPoolStats FieldBufferPool<ValueType>::stats() const
+{
+	return FieldBufferPoolStats{this->live_count, this->free_count, this->high_water_count};
+}
+
+template<typename ValueType>
+bool FieldBufferPool<ValueType>::is_pooled_volume(unsigned int volume)
+{
+	unsigned int buffer_volume = this->buffer_volume;
+	if (buffer_volume == 0)
+	{
+		/* The first request sets the volume (if no other thread did it first). */
+		this->buffer_volume.compare_exchange_strong(buffer_volume, volume);
+		buffer_volume = this->buffer_volume;
+	}
+	return volume == buffer_volume;
+}
+
+template<typename ValueType>
+typename FieldBufferPool<ValueType>::ThreadCache& FieldBufferPool<ValueType>::thread_cache()
+{
+	thread_local ThreadCache cache{this};
+	return cache;
+}
+
+template class FieldBufferPool<PtgFieldValue>;
+template class FieldBufferPool<PttFieldValue>;
+template class FieldBufferPool<BFieldValue>;
+
+} /* qwy2 */
@@ -0,0 +1,89 @@
+
+#ifndef QWY2_HEADER_FIELD_POOL_
+#define QWY2_HEADER_FIELD_POOL_
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+
+namespace qwy2
+{
+
+/* Numbers of buffers of a `FieldBufferPool`. */
+class FieldBufferPoolStats
+{
+public:
+	/* Buffers that are used by some fields. */
+	unsigned int live;
+	/* Buffers that are kept by the pool to be given again. */
+	unsigned int free;
+	/* The highest number of live buffers so far. */
+	unsigned int high_water;
+};
+
+/* Keeps the buffers of the chunk fields that hold values of the given type when they are
+ * freed, to give them again instead of allocating new ones. All the buffers have the same
+ * volume (the volume of the chunks, set by the first request), so there is no fragmentation,
+ * and a buffer of some other volume is just allocated and freed the usual way.
+ * Each thread keeps a few buffers in a cache of its own, and only locks the shared free
+ * list of the pool to exchange a bunch of buffers with it when its cache gets empty or full,
+ * so that the worker threads (that generate fields) and the main thread (that unloads them)
+ * rarely wait on each other. The freed buffers are never given back to the system,
+ * which makes for a stable memory usage that is as high as the highest number of fields. */
+template<typename ValueType>
+class FieldBufferPool
+{
+private:
+	class ThreadCache
+	{
+	public:
+		FieldBufferPool* pool;
+		std::vector<ValueType*> buffer_table;
+
+	public:
+		ThreadCache(FieldBufferPool* pool);
+		/* Gives the cached buffers back to the pool when the thread ends. */
+		~ThreadCache();
+	};
+
+	/* A thread cache never holds more buffers than this,
+	 * and exchanges half of that with the shared free list at once. */
+	static constexpr unsigned int THREAD_CACHE_CAPACITY = 16;
+
+private:
+	/* 0 until the first request sets it. */
+	std::atomic<unsigned int> buffer_volume;
+
+	std::mutex free_buffer_mutex;
+	std::vector<ValueType*> free_buffer_table;
+
+	std::atomic<unsigned int> live_count;
+	std::atomic<unsigned int> free_count;
+	std::atomic<unsigned int> high_water_count;
+
+public:
+	FieldBufferPool();
+	~FieldBufferPool();
+
+	/* The one pool for the buffers of the fields of that value type. */
+	static FieldBufferPool& global();
+
+	/* Returns a buffer of the given number of values (uninitialized). */
+	ValueType* acquire(unsigned int volume);
+
+	/* Takes back a buffer that was returned by `acquire` with the given volume.
+	 * Null is ignored. */
+	void release(ValueType* buffer, unsigned int volume);
+
+	FieldBufferPoolStats stats() const;
+
+private:
+	/* Does the given volume match the volume of the buffers of the pool? */
+	bool is_pooled_volume(unsigned int volume);
+
+	ThreadCache& thread_cache();
+};
+
+} /* qwy2 */
+
+#endif /* QWY2_HEADER_FIELD_POOL_ */
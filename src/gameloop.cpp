@@ -10,6 +10,7 @@
 #include "embedded.hpp"
 #include "opengl.hpp"
 #include "utils.hpp"
+#include "field_pool.hpp"
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/transform.hpp>
 #include <glm/gtx/rotate_vector.hpp>
@@ -142,70 +143,7 @@ void Game::init(Config const& config)
 	this->shader_table.init();
 
 	/* Generate the laws of nature. */
-	this->nature = new Nature{config.get<int>("seed"sv)};
-	this->nature->world_generator.plain_terrain_generator =
-		plain_terrain_generator_from_name(config.get<std::string_view>("terrain_generator"sv));
-	this->nature->world_generator.terrain_param_a =    config.get<float>("terrain_param_a"sv);
-	this->nature->world_generator.terrain_param_b =    config.get<float>("terrain_param_b"sv);
-	this->nature->world_generator.terrain_param_c =    config.get<float>("terrain_param_c"sv);
-	this->nature->world_generator.noise_size =         config.get<float>("noise_size"sv);
-	this->nature->world_generator.density =            config.get<float>("density"sv);
-	this->nature->world_generator.structures_enabled = config.get<bool>("structures"sv);
-	this->nature->world_generator.stone_terrain =      config.get<bool>("stone_terrain"sv);
-	/* Block type id 0 is air. */
-	this->nature->nature_generator.generate_block_type(*this->nature);
-	/* Block type id 1 is dirt covered with grass. */
-	this->nature->world_generator.surface_block_type =
-		this->nature->nature_generator.generate_block_type(*this->nature);
-	/* Block type id 2 is plain dirt. */
-	this->nature->world_generator.primary_block_type =
-		this->nature->nature_generator.generate_block_type(*this->nature);
-	/* Block type id 3 is plain rock. */
-	this->nature->world_generator.secondary_block_type =
-		this->nature->nature_generator.generate_block_type(*this->nature);
-	/* Block type id 4 is a white test block. */
-	this->nature->world_generator.test_block_type =
-		this->nature->nature_generator.generate_block_type(*this->nature);
-
-	/* Block type id 5-10 are some other random test block. */
-	for (int i = 0; i < 21; i++)
-	{
-		this->nature->nature_generator.generate_block_type(*this->nature);
-	}
-
-	/* Test structure. */
-	{
-		StructureGenerationProgram prog{};
-		prog.steps.push_back(new structure_generation_step::SearchGround{});
-			StructureGenerationProgram body{};
-			body.steps.push_back(new structure_generation_step::PlaceBlock{4, false});
-			body.steps.push_back(new structure_generation_step::MoveAtRandom{});
-		prog.steps.push_back(new structure_generation_step::Repeat{5, 100, body});
-		StructureType structure_type{prog};
-		this->nature->world_generator.structure_type_test =
-			this->nature->structure_type_table.size();
-		this->nature->structure_type_table.push_back(structure_type);
-	}
-
-	/* Test tree structure. */
-	{
-		StructureGenerationProgram prog{};
-		prog.steps.push_back(new structure_generation_step::SearchGround{});
-			StructureGenerationProgram body_a{};
-			body_a.steps.push_back(new structure_generation_step::PlaceBlock{5, false});
-			body_a.steps.push_back(new structure_generation_step::MoveUpwards{});
-		prog.steps.push_back(new structure_generation_step::Repeat{4, 7, body_a});
-			StructureGenerationProgram body_b{};
-				StructureGenerationProgram body_c{};
-				body_c.steps.push_back(new structure_generation_step::PlaceBlock{6, true});
-				body_c.steps.push_back(new structure_generation_step::MoveAtRandom{});
-			body_b.steps.push_back(new structure_generation_step::Repeat{4, 5, body_c});
-		prog.steps.push_back(new structure_generation_step::RepeatFromSamePosition{50, 100, body_b});
-		StructureType structure_type{prog};
-		this->nature->world_generator.structure_type_test_tree =
-			this->nature->structure_type_table.size();
-		this->nature->structure_type_table.push_back(structure_type);
-	}
+	this->nature = generate_nature(config, true);
 	
 	/* Emit the texture atlas if requested. */
 	if (config.get<bool>("emit_bitmap"sv)) {
@@ -230,6 +168,9 @@ void Game::init(Config const& config)
 	this->shader_table.update_uniform(Uniform::ATLAS_SIDE, static_cast<float>(nature->atlas.side));
 	glActiveTexture(GL_TEXTURE0 + 0);
 
+	/* Give the atlas rects of the block types to the chunk shaders. */
+	this->shader_table.chunk().update_block_type_table(this->nature->block_type_table);
+
 	/* Define the sun's camera that will cast shadows on the world. */
 	//this->sun_position = glm::vec3{100.0f, 500.0f, 1000.0f};
 	this->sun_camera = Camera<OrthographicProjection>{
@@ -283,13 +224,13 @@ void Game::init(Config const& config)
 	unsigned int const loading_threads = config.get<int>("loading_threads"sv);
 	this->thread_pool.set_thread_number(loading_threads);
 	this->chunk_generation_manager.thread_pool = &this->thread_pool;
-	/* Note: The `+ 2` here is arbitrary.
-	 * TODO: Make this configurable or find a value that makes sense or both (even better). */
-	this->chunk_generation_manager.generating_data_vector.resize(loading_threads + 2);
+	unsigned int const max_generation_tasks = config.get<int>("max_generation_tasks"sv);
+	this->chunk_generation_manager.generating_data_cap =
+		max_generation_tasks == 0 ? loading_threads + 2 : max_generation_tasks;
 
 	/* Initialize the grid of chunks and related fields. */
-	this->chunk_side = config.get<int>("chunk_side"sv);
-	this->chunk_grid = new ChunkGrid{};
+	ChunkGeometry const chunk_geometry{config.get<int>("chunk_side"sv)};
+	this->chunk_grid = new ChunkGrid{chunk_geometry, this->save_directory + "chunks/"};
 	this->chunk_generation_manager.chunk_grid = this->chunk_grid;
 	this->loaded_radius = config.get<float>("loaded_radius"sv);
 	this->unloaded_margin = config.get<float>("unloaded_margin"sv);
@@ -297,11 +238,48 @@ void Game::init(Config const& config)
 	this->chunk_generation_manager.unloading_margin = this->unloaded_margin;
 
 	this->chunk_generation_manager.load_save_enabled = config.get<bool>("load_save"sv);
-	this->chunk_generation_manager.save_only_modified = config.get<bool>("save_only_modified"sv);
+	this->chunk_generation_manager.priority_weights.view =
+		config.get<float>("generation_priority_view"sv);
+	this->chunk_generation_manager.priority_weights.motion =
+		config.get<float>("generation_priority_motion"sv);
+	this->chunk_generation_manager.priority_weights.falling =
+		config.get<float>("generation_priority_falling"sv);
+	this->chunk_grid->save_only_modified = config.get<bool>("save_only_modified"sv);
+	this->chunk_grid->padded_neighborhoods = config.get<bool>("padded_neighborhoods"sv);
+	this->chunk_grid->greedy_meshing = config.get<bool>("greedy_meshing"sv);
+	this->chunk_grid->save_signature = ChunkSaveSignature{chunk_geometry,
+		config.get<std::string_view>("terrain_generator"sv), config.get<int>("seed"sv)};
+	if (config.get<bool>("chunk_grid_ring_buffer"sv))
+	{
+		/* Chunks are unloaded once they get outside of the unloading distance, and the few
+		 * chunks (PTG and PTT fields) that get generated around the loaded chunks are well
+		 * within that distance, so the loaded chunks fit in a cube of that diameter.
+		 * Some margin is added as the player may move a bit before far chunks get unloaded. */
+		float const unloaded_radius = this->loaded_radius + this->unloaded_margin;
+		unsigned int const ring_side =
+			2 * static_cast<unsigned int>(std::ceil(unloaded_radius / chunk_geometry.side)) + 5;
+		this->chunk_grid->use_ring_buffer(ring_side);
+	}
 	if (this->chunk_generation_manager.load_save_enabled)
 	{
-		std::string chunk_save_directory{std::string(this->save_directory) + "chunks/"};
-		std::filesystem::create_directories(chunk_save_directory);
+		std::filesystem::create_directories(this->chunk_grid->chunk_save_directory);
+
+		/* Saves from before the region files have one file per chunk. */
+		unsigned int const converted_chunk_count = convert_chunk_files_to_region_files(
+			this->chunk_grid->chunk_save_directory, this->chunk_grid->region_file_table);
+		if (converted_chunk_count != 0)
+		{
+			std::cout << "[Init] "
+				<< "Converted " << converted_chunk_count << " chunk files to region files."
+				<< std::endl;
+		}
+		std::cout << "[Init] "
+			<< "Found " << this->chunk_grid->region_file_table.saved_chunk_count()
+			<< " saved chunks." << std::endl;
+
+		this->chunk_grid->region_file_table.use_memory_mapping(
+			config.get<bool>("mmap_region_files"sv));
+		this->chunk_grid->save_writer.start(this->chunk_grid->save_signature);
 	}
 
 	/* Place the player. */
@@ -323,6 +301,9 @@ void Game::init(Config const& config)
 	this->player_camera = Camera<PerspectiveProjection>{
 		PerspectiveProjection{fovy, aspect_ratio},
 		0.1f, this->loaded_radius * 2.5f};
+	/* The angle between the view direction and the corners of the view. */
+	this->chunk_generation_manager.view_half_angle = std::atan(
+		std::tan(fovy / 2.0f) * std::sqrt(1.0f + aspect_ratio * aspect_ratio));
 
 	/* Handle the cursor's capture and sensibility. */
 	this->cursor_is_captured = config.get<bool>("cursor_capture"sv);
@@ -391,6 +372,25 @@ void Game::loop()
 		GlopColumnId glop_chunk_ptt_count =  this->glop.add_column("PTT count");
 		GlopColumnId glop_chunk_b_count =    this->glop.add_column("B count");
 		GlopColumnId glop_chunk_mesh_count = this->glop.add_column("Chunk mesh count");
+		/* Numbers of buffers of the pools of chunk field buffers, see `FieldBufferPool`. */
+		GlopColumnId glop_ptg_buffer_live =       this->glop.add_column("PTG buffers live");
+		GlopColumnId glop_ptg_buffer_free =       this->glop.add_column("PTG buffers free");
+		GlopColumnId glop_ptg_buffer_high_water = this->glop.add_column("PTG buffers high-water");
+		GlopColumnId glop_ptt_buffer_live =       this->glop.add_column("PTT buffers live");
+		GlopColumnId glop_ptt_buffer_free =       this->glop.add_column("PTT buffers free");
+		GlopColumnId glop_ptt_buffer_high_water = this->glop.add_column("PTT buffers high-water");
+		GlopColumnId glop_b_buffer_live =         this->glop.add_column("B buffers live");
+		GlopColumnId glop_b_buffer_free =         this->glop.add_column("B buffers free");
+		GlopColumnId glop_b_buffer_high_water =   this->glop.add_column("B buffers high-water");
+		/* Latency between a block modification and its remeshed chunk being rendered,
+		 * for the frames in which such a remeshing lands. */
+		GlopColumnId glop_remesh_latency_frames = this->glop.add_column("Remesh latency frames");
+		GlopColumnId glop_remesh_latency_ms =     this->glop.add_column("Remesh latency ms");
+		/* How fast the player gets to see stuff since the last chunk boundary crossing,
+		 * see `ChunkGenerationViewMetrics` (0 until measured). */
+		GlopColumnId glop_time_to_first_visible_ground =
+			this->glop.add_column("Time to first visible ground");
+		GlopColumnId glop_time_to_fill_view = this->glop.add_column("Time to fill view");
 		/* Timers of different sections of the game loop. */
 		GlopColumnId glop_time_all =               this->glop.add_column("Timer: All");
 		GlopColumnId glop_time_event_handling =    this->glop.add_column("Timer: Event handling");
@@ -429,6 +429,9 @@ void Game::loop()
 		/* Apply controls, motion and collisions to the player. */
 		this->player.apply_motion(*this->chunk_grid, this->player_controls, delta_time);
 		this->chunk_generation_manager.generation_center = this->player.box.center;
+		this->chunk_generation_manager.view_direction = this->player.direction();
+		this->chunk_generation_manager.player_motion = this->player.motion;
+		this->chunk_generation_manager.player_is_falling = this->player.is_falling;
 
 		/* Generate chunks around the player. */
 		{
@@ -439,6 +442,9 @@ void Game::loop()
 		/* Apply behaviors and physics to entities. */
 		{
 			TIME_BLOCK(glop_time_entity_behavior);
+			/* Entities that moved to an other chunk are added back to the grid after the
+			 * loop, as adding them may insert into the entity table that is iterated over. */
+			std::vector<Entity*> moved_entity_table;
 			for (auto& [chunk_coords, entity_table] : this->chunk_grid->entity_table)
 			{
 				for (Entity*& entity : entity_table.entities)
@@ -455,16 +461,20 @@ void Game::loop()
 						/* The entity may have moved out of the chunk, which
 						 * will require to move the entity to its new chunk. */
 						BlockCoords coords{entity->coords};
-						ChunkCoords new_chunk_coords = containing_chunk_coords(coords);
+						ChunkCoords new_chunk_coords =
+							this->chunk_grid->geometry.containing_chunk_coords(coords);
 						if (new_chunk_coords != chunk_coords)
 						{
-							Entity* entity_ptr = entity;
+							moved_entity_table.push_back(entity);
 							entity = nullptr;
-							this->chunk_grid->add_entity(entity_ptr);
 						}
 					}
 				}
 			}
+			for (Entity* entity : moved_entity_table)
+			{
+				this->chunk_grid->add_entity(entity);
+			}
 		}
 
 		/* Handle the player's camera. */
@@ -536,7 +546,9 @@ void Game::loop()
 			{
 				if (mesh.openglid != 0)
 				{
-					this->shader_table.shadow().draw(mesh);
+					glm::vec3 const origin_coords =
+						this->chunk_grid->geometry.most_negativeward_corner_coords(chunk_coords);
+					this->shader_table.chunk_shadow().draw(mesh, origin_coords);
 				}
 			}
 			for (auto const& [chunk_coords, entity_table] : this->chunk_grid->entity_table)
@@ -576,7 +588,9 @@ void Game::loop()
 			{
 				if (mesh.openglid != 0)
 				{
-					this->shader_table.classic().draw(mesh);
+					glm::vec3 const origin_coords =
+						this->chunk_grid->geometry.most_negativeward_corner_coords(chunk_coords);
+					this->shader_table.chunk().draw(mesh, origin_coords);
 				}
 			}
 		}
@@ -673,9 +687,23 @@ void Game::loop()
 			if (this->see_chunk_borders)
 			{
 				this->line_rect_drawer.color = glm::vec3{0.0f, 0.4f, 0.8f};
+				std::vector<ChunkCoords> loaded_chunk_coords_table;
+				for (auto const& [chunk_coords, chunk_b_field] : this->chunk_grid->b_field)
+				{
+					loaded_chunk_coords_table.push_back(chunk_coords);
+				}
+				/* The PTG fields of the chunks that have a B field may have been unloaded. */
 				for (auto const& [chunk_coords, chunk_ptg_field] : this->chunk_grid->ptg_field)
 				{
-					AlignedBox const box = block_rect_box(chunk_block_rect(chunk_coords));
+					if (not this->chunk_grid->has_b_field(chunk_coords))
+					{
+						loaded_chunk_coords_table.push_back(chunk_coords);
+					}
+				}
+				for (ChunkCoords const chunk_coords : loaded_chunk_coords_table)
+				{
+					AlignedBox const box = block_rect_box(
+						this->chunk_grid->geometry.block_rect(chunk_coords));
 					this->line_rect_drawer.set_box(box);
 					this->shader_table.line().draw(this->line_rect_drawer.mesh);
 				}
@@ -683,15 +711,10 @@ void Game::loop()
 
 			if (this->see_chunk_generation)
 			{
-				for (std::optional<qwy2::ChunkGeneratingData> const& chunk_generarion_opt :
-					this->chunk_generation_manager.generating_data_vector)
+				for (ChunkGeneratingData const& chunk_generarion :
+					this->chunk_generation_manager.generating_data_set)
 				{
-					if (not chunk_generarion_opt.has_value())
-					{
-						continue;
-					}
-
-					switch (chunk_generarion_opt.value().step)
+					switch (chunk_generarion.step)
 					{
 						case ChunkGeneratingStep::MESH:
 							this->line_rect_drawer.color = glm::vec3{1.0f, 1.0f, 1.0f};
@@ -701,8 +724,9 @@ void Game::loop()
 						break;
 					}
 
-					ChunkCoords const chunk_coords = chunk_generarion_opt.value().chunk_coords;
-					AlignedBox const box = block_rect_box(chunk_block_rect(chunk_coords));
+					ChunkCoords const chunk_coords = chunk_generarion.chunk_coords;
+					AlignedBox const box = block_rect_box(
+						this->chunk_grid->geometry.block_rect(chunk_coords));
 					this->line_rect_drawer.set_box(box);
 					this->shader_table.line().draw(this->line_rect_drawer.mesh);
 				}
@@ -724,7 +748,8 @@ void Game::loop()
 						this->line_rect_drawer.color = glm::vec3{1.0f, 1.0f, 1.0f};
 					}
 
-					AlignedBox box = block_rect_box(chunk_block_rect(chunk_coords));
+					AlignedBox box = block_rect_box(
+						this->chunk_grid->geometry.block_rect(chunk_coords));
 					box.dimensions -= glm::vec3{1.0f, 1.0f, 1.0f};
 					this->line_rect_drawer.set_box(box);
 					this->shader_table.line().draw(this->line_rect_drawer.mesh);
@@ -760,6 +785,32 @@ void Game::loop()
 			this->glop.set_column_value(glop_chunk_ptt_count,  this->chunk_grid->ptt_field.size());
 			this->glop.set_column_value(glop_chunk_b_count,    this->chunk_grid->b_field.size());
 			this->glop.set_column_value(glop_chunk_mesh_count, this->chunk_grid->mesh.size());
+			auto const set_buffer_pool_columns = [this](FieldBufferPoolStats stats,
+				GlopColumnId live_id, GlopColumnId free_id, GlopColumnId high_water_id
+			){
+				this->glop.set_column_value(live_id,       stats.live);
+				this->glop.set_column_value(free_id,       stats.free);
+				this->glop.set_column_value(high_water_id, stats.high_water);
+			};
+			set_buffer_pool_columns(FieldBufferPool<PtgFieldValue>::global().stats(),
+				glop_ptg_buffer_live, glop_ptg_buffer_free, glop_ptg_buffer_high_water);
+			set_buffer_pool_columns(FieldBufferPool<PttFieldValue>::global().stats(),
+				glop_ptt_buffer_live, glop_ptt_buffer_free, glop_ptt_buffer_high_water);
+			set_buffer_pool_columns(FieldBufferPool<BFieldValue>::global().stats(),
+				glop_b_buffer_live, glop_b_buffer_free, glop_b_buffer_high_water);
+			if (this->chunk_generation_manager.last_remesh_latency.has_value())
+			{
+				ChunkRemeshLatency const latency =
+					this->chunk_generation_manager.last_remesh_latency.value();
+				this->glop.set_column_value(glop_remesh_latency_frames, latency.frames);
+				this->glop.set_column_value(glop_remesh_latency_ms, latency.milliseconds);
+			}
+			ChunkGenerationViewMetrics const& view_metrics =
+				this->chunk_generation_manager.view_metrics;
+			this->glop.set_column_value(glop_time_to_first_visible_ground,
+				view_metrics.time_to_first_visible_ground.value_or(0.0f));
+			this->glop.set_column_value(glop_time_to_fill_view,
+				view_metrics.time_to_fill_view.value_or(0.0f));
 			this->glop.emit_row();
 		#endif
 
@@ -785,10 +836,20 @@ void Game::loop()
 	/* TODO: Make this better. */
 	if (this->chunk_generation_manager.load_save_enabled)
 	{
-		std::string chunk_save_directory{std::string(this->save_directory) + "chunks/"};
+		/* The B fields are written by the save writer thread, that may still have some
+		 * to write from the chunks unloaded just before. */
 		this->chunk_grid->save_all_that_is_necessary();
+		ChunkSaveWriter& save_writer = this->chunk_grid->save_writer;
+		while (not save_writer.wait_until_all_written(std::chrono::milliseconds{500}))
+		{
+			std::cout << "[Cleanup] "
+				<< "Saving chunk B fields, " << save_writer.unwritten_count() << " left."
+				<< std::endl;
+		}
 		std::cout << "[Cleanup] "
-			<< "Saved chunk B fields to \"" << chunk_save_directory << "\"." << std::endl;
+			<< "Saved chunk B fields to \"" << this->chunk_grid->chunk_save_directory << "\""
+			<< " (" << save_writer.total_written_count() << " written during the game)."
+			<< std::endl;
 
 		/* TODO: Make this BETTER. Currently this is UGLY and it shall not remain that way! */
 		std::string some_data_save_file{std::string(this->save_directory) + "somedata"};
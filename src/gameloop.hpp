@@ -32,11 +32,9 @@ public:
 	 * and some stuff can change depending on the seed and this is what `Nature` describes. */
 	Nature* nature;
 
-	/* Most of the chunk data about all the chunks are in there. */
+	/* Most of the chunk data about all the chunks are in there,
+	 * including the shape of the chunks. */
 	ChunkGrid* chunk_grid;
-	/* The length of the edges of the chunks, in blocks.
-	 * It must be odd, and should be at least 15 or something. */
-	unsigned int chunk_side;
 
 	/* Manages chunk generatation, like which thread get to do which step of which chunk, etc. */
 	ChunkGenerationManager chunk_generation_manager;
@@ -1,6 +1,7 @@
 
 #include "config.hpp"
 #include "gameloop.hpp"
+#include "benchmark.hpp"
 #include <iostream>
 
 int main(int argc, char const* const* argv)
@@ -20,6 +21,13 @@ int main(int argc, char const* const* argv)
 		return EXIT_FAILURE;
 	}
 
+	using namespace std::literals::string_view_literals;
+	if (config.get<bool>("benchmark"sv))
+	{
+		return run_chunk_generation_benchmark(config) == ErrorCode::OK ?
+			EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
 	/* All the cool stuff happens in there ^^. */
 	g_game = new Game{};
 	g_game->init(config);
@@ -1,10 +1,12 @@
 
 #include "mesh.hpp"
 #include "shaders/classic/classic.hpp"
+#include "shaders/chunk/chunk.hpp"
 #include "shaders/line/line.hpp"
 #include "shaders/line_ui/line_ui.hpp"
 #include "shaders/simple/simple.hpp"
 #include <cassert>
+#include <algorithm>
 
 namespace qwy2
 {
@@ -18,7 +20,8 @@ Mesh<VertexDataType>::Mesh():
 
 template<typename VertexDataType>
 Mesh<VertexDataType>::Mesh(GLenum opengl_buffer_usage):
-	opengl_buffer_usage{opengl_buffer_usage}, openglid{0}
+	opengl_buffer_usage{opengl_buffer_usage}, openglid{0}, needs_update_opengl_data{false},
+	opengl_buffer_vertex_count{0}
 {
 	#if 0
 	glGenBuffers(1, &this->openglid);
@@ -35,25 +38,137 @@ Mesh<VertexDataType>::~Mesh()
 	}
 }
 
+template<typename VertexDataType>
+Mesh<VertexDataType>::Mesh(Mesh&& other):
+	vertex_data{std::move(other.vertex_data)},
+	opengl_buffer_usage{other.opengl_buffer_usage},
+	openglid{other.openglid},
+	needs_update_opengl_data{other.needs_update_opengl_data},
+	dirty_vertex_range{other.dirty_vertex_range},
+	opengl_buffer_vertex_count{other.opengl_buffer_vertex_count}
+{
+	other.openglid = 0;
+	other.opengl_buffer_vertex_count = 0;
+}
+
+template<typename VertexDataType>
+Mesh<VertexDataType>& Mesh<VertexDataType>::operator=(Mesh&& other)
+{
+	if (this != &other)
+	{
+		if (this->openglid != 0)
+		{
+			glDeleteBuffers(1, &this->openglid);
+		}
+		this->vertex_data = std::move(other.vertex_data);
+		this->opengl_buffer_usage = other.opengl_buffer_usage;
+		this->openglid = other.openglid;
+		this->needs_update_opengl_data = other.needs_update_opengl_data;
+		this->dirty_vertex_range = other.dirty_vertex_range;
+		this->opengl_buffer_vertex_count = other.opengl_buffer_vertex_count;
+		other.openglid = 0;
+		other.opengl_buffer_vertex_count = 0;
+	}
+	return *this;
+}
+
+template<typename VertexDataType>
+void Mesh<VertexDataType>::mark_dirty_range(
+	unsigned int first_vertex_index, unsigned int end_vertex_index)
+{
+	if (this->needs_update_opengl_data && not this->dirty_vertex_range.has_value())
+	{
+		/* Everything is already to be uploaded. */
+		return;
+	}
+	if (this->dirty_vertex_range.has_value())
+	{
+		auto& [first, end] = this->dirty_vertex_range.value();
+		first = std::min(first, first_vertex_index);
+		end = std::max(end, end_vertex_index);
+	}
+	else
+	{
+		this->dirty_vertex_range = std::make_pair(first_vertex_index, end_vertex_index);
+	}
+	this->needs_update_opengl_data = true;
+}
+
 template<typename VertexDataType>
 void Mesh<VertexDataType>::update_opengl_data()
 {
+	bool const only_dirty_range =
+		this->openglid != 0 &&
+		this->dirty_vertex_range.has_value() &&
+		this->opengl_buffer_vertex_count == this->vertex_data.size();
 	if (this->openglid == 0)
 	{
 		glGenBuffers(1, &this->openglid);
 		assert(this->openglid != 0);
 	}
 	glBindBuffer(GL_ARRAY_BUFFER, this->openglid);
-	glBufferData(GL_ARRAY_BUFFER, 
-		this->vertex_data.size() * sizeof(VertexDataType),
-		this->vertex_data.data(),
-		this->opengl_buffer_usage);
-	/* TODO: Optimize, maybe using glBufferSubData. */
+	if (only_dirty_range)
+	{
+		auto const [first, end] = this->dirty_vertex_range.value();
+		glBufferSubData(GL_ARRAY_BUFFER,
+			first * sizeof(VertexDataType),
+			(end - first) * sizeof(VertexDataType),
+			this->vertex_data.data() + first);
+	}
+	else
+	{
+		glBufferData(GL_ARRAY_BUFFER, 
+			this->vertex_data.size() * sizeof(VertexDataType),
+			this->vertex_data.data(),
+			this->opengl_buffer_usage);
+		this->opengl_buffer_vertex_count = this->vertex_data.size();
+	}
 
+	this->dirty_vertex_range.reset();
 	this->needs_update_opengl_data = false;
 }
 
+namespace
+{
+
+/* See `bind_quad_index_buffer`. */
+GLuint g_quad_index_buffer_openglid = 0;
+unsigned int g_quad_index_buffer_quad_count = 0;
+
+} /* Anonymous namespace. */
+
+void bind_quad_index_buffer(unsigned int quad_count)
+{
+	if (g_quad_index_buffer_openglid == 0)
+	{
+		glGenBuffers(1, &g_quad_index_buffer_openglid);
+		assert(g_quad_index_buffer_openglid != 0);
+	}
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_quad_index_buffer_openglid);
+
+	if (g_quad_index_buffer_quad_count < quad_count)
+	{
+		/* Grow geometrically so that it does not happen too often. */
+		unsigned int const new_quad_count =
+			std::max(quad_count, g_quad_index_buffer_quad_count * 2);
+		std::vector<GLuint> index_data;
+		index_data.reserve(new_quad_count * 6);
+		for (GLuint i = 0; i < new_quad_count; i++)
+		{
+			index_data.insert(index_data.end(), {
+				i * 4 + 0, i * 4 + 1, i * 4 + 2,
+				i * 4 + 0, i * 4 + 2, i * 4 + 3});
+		}
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+			index_data.size() * sizeof(GLuint),
+			index_data.data(),
+			GL_STATIC_DRAW);
+		g_quad_index_buffer_quad_count = new_quad_count;
+	}
+}
+
 template class Mesh<VertexDataClassic>;
+template class Mesh<VertexDataChunk>;
 template class Mesh<VertexDataLine>;
 template class Mesh<VertexDataLineUi>;
 template class Mesh<VertexDataSimple>;
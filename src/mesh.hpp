@@ -4,6 +4,8 @@
 
 #include "opengl.hpp"
 #include <vector>
+#include <optional>
+#include <utility>
 
 namespace qwy2
 {
@@ -18,14 +20,41 @@ public:
 	GLuint openglid;
 	bool needs_update_opengl_data;
 
+	/* If set, then only the vertices in this range (first index included, last excluded)
+	 * were modified since the last update of the OpenGL buffer (see `mark_dirty_range`). */
+	std::optional<std::pair<unsigned int, unsigned int>> dirty_vertex_range;
+
+	/* The number of vertices in the OpenGL buffer. */
+	unsigned int opengl_buffer_vertex_count;
+
 public:
 	Mesh();
 	Mesh(GLenum opengl_buffer_usage);
 	~Mesh();
 
+	/* A mesh owns its OpenGL buffer, so it can be moved (leaving the moved-from mesh
+	 * without a buffer) but not copied. */
+	Mesh(Mesh const&) = delete;
+	Mesh& operator=(Mesh const&) = delete;
+	Mesh(Mesh&& other);
+	Mesh& operator=(Mesh&& other);
+
+	/* Marks the vertices in the given range (first index included, last excluded) as modified,
+	 * so that the next update of the OpenGL buffer only uploads the modified vertices
+	 * (given that the vertex count did not change, else everything is uploaded).
+	 * Setting `needs_update_opengl_data` to true without calling this method
+	 * requires resetting `dirty_vertex_range` for everything to be uploaded. */
+	void mark_dirty_range(unsigned int first_vertex_index, unsigned int end_vertex_index);
+
 	void update_opengl_data();
 };
 
+/* Some meshes (like chunk meshes) are made of quads, 4 consecutive vertices each, that are
+ * drawn as the two triangles 0-1-2 and 0-2-3 via one element buffer shared by all of them.
+ * This binds that element buffer (to GL_ELEMENT_ARRAY_BUFFER), after growing it if it is
+ * too small to draw the given number of quads. Its indices are of type GL_UNSIGNED_INT. */
+void bind_quad_index_buffer(unsigned int quad_count);
+
 } /* qwy2 */
 
 #endif /* QWY2_HEADER_MESH_ */
@@ -1,6 +1,8 @@
 
 #include "nature.hpp"
 #include "chunk.hpp"
+#include "terrain_gen.hpp"
+#include "config.hpp"
 #include <cassert>
 #include <iostream>
 #include <algorithm>
@@ -54,11 +56,17 @@ AtlasRect PixelRect::atlas_rect() const
 	return rect;
 }
 
-Atlas::Atlas(unsigned int side):
-	side{side}, data{new PixelData[side * side]}
+Atlas::Atlas(unsigned int side, bool opengl_enabled):
+	side{side}, data{new PixelData[side * side]}, texture_openglid{0},
+	opengl_enabled{opengl_enabled}
 {
 	std::fill(this->data, this->data + this->side * this->side, PixelData::UNUSED);
 
+	if (not this->opengl_enabled)
+	{
+		return;
+	}
+
 	GLint max_atlas_side;
 	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_atlas_side);
 	if (static_cast<unsigned int>(max_atlas_side) < this->side)
@@ -120,6 +128,10 @@ PixelRect Atlas::allocate_rect(unsigned int w, unsigned int h)
 
 void Atlas::update_opengl_data()
 {
+	if (not this->opengl_enabled)
+	{
+		return;
+	}
 	glBindTexture(GL_TEXTURE_2D, this->texture_openglid);
 	/* TODO: Optimize ^^. */
 	glTexSubImage2D(GL_TEXTURE_2D, 0,
@@ -462,10 +474,82 @@ BlockTypeId NatureGenerator::generate_block_type(Nature& nature)
 	return block_type_index;
 }
 
-Nature::Nature(NoiseGenerator::SeedType seed):
-	atlas{1024}, world_generator{seed}, nature_generator{seed}
+Nature::Nature(NoiseGenerator::SeedType seed, bool opengl_enabled):
+	atlas{1024, opengl_enabled}, world_generator{seed}, nature_generator{seed}
 {
 	;
 }
 
+Nature* generate_nature(Config const& config, bool opengl_enabled)
+{
+	using namespace std::literals::string_view_literals;
+
+	Nature* nature = new Nature{config.get<int>("seed"sv), opengl_enabled};
+	nature->world_generator.plain_terrain_generator =
+		plain_terrain_generator_from_name(config.get<std::string_view>("terrain_generator"sv));
+	nature->world_generator.terrain_param_a =    config.get<float>("terrain_param_a"sv);
+	nature->world_generator.terrain_param_b =    config.get<float>("terrain_param_b"sv);
+	nature->world_generator.terrain_param_c =    config.get<float>("terrain_param_c"sv);
+	nature->world_generator.noise_size =         config.get<float>("noise_size"sv);
+	nature->world_generator.density =            config.get<float>("density"sv);
+	nature->world_generator.structures_enabled = config.get<bool>("structures"sv);
+	nature->world_generator.stone_terrain =      config.get<bool>("stone_terrain"sv);
+	/* Block type id 0 is air. */
+	nature->nature_generator.generate_block_type(*nature);
+	/* Block type id 1 is dirt covered with grass. */
+	nature->world_generator.surface_block_type =
+		nature->nature_generator.generate_block_type(*nature);
+	/* Block type id 2 is plain dirt. */
+	nature->world_generator.primary_block_type =
+		nature->nature_generator.generate_block_type(*nature);
+	/* Block type id 3 is plain rock. */
+	nature->world_generator.secondary_block_type =
+		nature->nature_generator.generate_block_type(*nature);
+	/* Block type id 4 is a white test block. */
+	nature->world_generator.test_block_type =
+		nature->nature_generator.generate_block_type(*nature);
+
+	/* Block type id 5-10 are some other random test block. */
+	for (int i = 0; i < 21; i++)
+	{
+		nature->nature_generator.generate_block_type(*nature);
+	}
+
+	/* Test structure. */
+	{
+		StructureGenerationProgram prog{};
+		prog.steps.push_back(new structure_generation_step::SearchGround{});
+			StructureGenerationProgram body{};
+			body.steps.push_back(new structure_generation_step::PlaceBlock{4, false});
+			body.steps.push_back(new structure_generation_step::MoveAtRandom{});
+		prog.steps.push_back(new structure_generation_step::Repeat{5, 100, body});
+		StructureType structure_type{prog};
+		nature->world_generator.structure_type_test =
+			nature->structure_type_table.size();
+		nature->structure_type_table.push_back(structure_type);
+	}
+
+	/* Test tree structure. */
+	{
+		StructureGenerationProgram prog{};
+		prog.steps.push_back(new structure_generation_step::SearchGround{});
+			StructureGenerationProgram body_a{};
+			body_a.steps.push_back(new structure_generation_step::PlaceBlock{5, false});
+			body_a.steps.push_back(new structure_generation_step::MoveUpwards{});
+		prog.steps.push_back(new structure_generation_step::Repeat{4, 7, body_a});
+			StructureGenerationProgram body_b{};
+				StructureGenerationProgram body_c{};
+				body_c.steps.push_back(new structure_generation_step::PlaceBlock{6, true});
+				body_c.steps.push_back(new structure_generation_step::MoveAtRandom{});
+			body_b.steps.push_back(new structure_generation_step::Repeat{4, 5, body_c});
+		prog.steps.push_back(new structure_generation_step::RepeatFromSamePosition{50, 100, body_b});
+		StructureType structure_type{prog};
+		nature->world_generator.structure_type_test_tree =
+			nature->structure_type_table.size();
+		nature->structure_type_table.push_back(structure_type);
+	}
+
+	return nature;
+}
+
 } /* qwy2 */
@@ -68,9 +68,12 @@ public:
 	unsigned int side;
 	PixelData* data;
 	unsigned int texture_openglid;
+	/* If false, then there is no OpenGL texture and no OpenGL call is ever made,
+	 * which allows to use an atlas without any OpenGL context (like for benchmarks). */
+	bool opengl_enabled;
 
 public:
-	Atlas(unsigned int side);
+	Atlas(unsigned int side, bool opengl_enabled);
 	~Atlas();
 
 	PixelRect allocate_rect(unsigned int w, unsigned int h);
@@ -142,9 +145,16 @@ public:
 	NatureGenerator nature_generator;
 
 public:
-	Nature(NoiseGenerator::SeedType seed);
+	Nature(NoiseGenerator::SeedType seed, bool opengl_enabled);
 };
 
+class Config;
+
+/* Generates the laws of nature as described by the given configuration,
+ * including all the block types and structure types that world generation expects.
+ * If `opengl_enabled` is false, then no OpenGL call is made (see `Atlas::opengl_enabled`). */
+Nature* generate_nature(Config const& config, bool opengl_enabled);
+
 } /* qwy2 */
 
 #endif /* QWY2_HEADER_NATURE_ */
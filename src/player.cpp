@@ -142,7 +142,8 @@ void Player::apply_motion(ChunkGrid const& chunk_grid, PlayerControls const& con
 	}
 
 	glm::vec3 motion_remaining = this->motion * delta_time_in_60_fps_frames;
-	if (not chunk_grid.has_complete_mesh(containing_chunk_coords(this->box.center)))
+	ChunkCoords const chunk_coords = chunk_grid.geometry.containing_chunk_coords(this->box.center);
+	if (not chunk_grid.has_complete_mesh(chunk_coords))
 	{
 		/* Prevents falling through unloaded floor. */
 		motion_remaining.z = 0.0f;
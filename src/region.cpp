@@ -0,0 +1,486 @@
+
+#include "region.hpp"
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <filesystem>
+#include <algorithm>
+#include <optional>
+#include <system_error>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace qwy2
+{
+
+RegionFile::RegionFile(std::string file_name):
+	file_name{file_name},
+	location_table(CHUNK_COUNT, ChunkLocation{0, 0}),
+	sector_is_used_table(HEADER_SECTOR_COUNT, true)
+{
+	this->file.open(this->file_name, std::ios::binary | std::ios::in | std::ios::out);
+	if (not this->file.is_open())
+	{
+		/* The file does not exist yet. */
+		return;
+	}
+
+	std::vector<char> header(HEADER_BYTE_SIZE);
+	this->file.read(header.data(), HEADER_BYTE_SIZE);
+	std::uint32_t format_version;
+	std::memcpy(&format_version, header.data() + sizeof MAGIC, sizeof format_version);
+	if ((not this->file.good()) ||
+		std::memcmp(header.data(), MAGIC, sizeof MAGIC) != 0 ||
+		format_version != FORMAT_VERSION)
+	{
+		std::cout << "\x1b[31mError:\x1b[39m "
+			<< "The region file \"" << this->file_name << "\" is not a valid region file."
+			<< std::endl;
+		assert(false);
+		std::exit(EXIT_FAILURE);
+	}
+	std::memcpy(this->location_table.data(), header.data() + LOCATION_TABLE_OFFSET,
+		CHUNK_COUNT * sizeof (ChunkLocation));
+
+	for (ChunkLocation const& location : this->location_table)
+	{
+		if (location.byte_size == 0)
+		{
+			continue;
+		}
+		unsigned int const sector_count = (location.byte_size + SECTOR_SIZE - 1) / SECTOR_SIZE;
+		unsigned int const end_sector = location.first_sector + sector_count;
+		if (this->sector_is_used_table.size() < end_sector)
+		{
+			this->sector_is_used_table.resize(end_sector, false);
+		}
+		std::fill(
+			this->sector_is_used_table.begin() + location.first_sector,
+			this->sector_is_used_table.begin() + end_sector,
+			true);
+	}
+}
+
+std::vector<bool> RegionFile::read_saved_chunk_table(std::string const& file_name)
+{
+	std::ifstream file{file_name, std::ios::binary};
+	std::vector<char> header(HEADER_BYTE_SIZE);
+	file.read(header.data(), HEADER_BYTE_SIZE);
+	std::uint32_t format_version;
+	std::memcpy(&format_version, header.data() + sizeof MAGIC, sizeof format_version);
+	if ((not file.good()) ||
+		std::memcmp(header.data(), MAGIC, sizeof MAGIC) != 0 ||
+		format_version != FORMAT_VERSION)
+	{
+		return std::vector<bool>{};
+	}
+	std::vector<ChunkLocation> location_table(CHUNK_COUNT);
+	std::memcpy(location_table.data(), header.data() + LOCATION_TABLE_OFFSET,
+		CHUNK_COUNT * sizeof (ChunkLocation));
+
+	std::vector<bool> saved_chunk_table(CHUNK_COUNT, false);
+	for (unsigned int i = 0; i < CHUNK_COUNT; i++)
+	{
+		saved_chunk_table[i] = location_table[i].byte_size != 0;
+	}
+	return saved_chunk_table;
+}
+
+MappedFile::MappedFile(std::string const& file_name, std::size_t byte_size):
+	address{nullptr},
+	byte_size{byte_size}
+{
+	int const file_descriptor = ::open(file_name.c_str(), O_RDONLY);
+	if (file_descriptor == -1)
+	{
+		return;
+	}
+	void* const address = ::mmap(nullptr, byte_size, PROT_READ, MAP_SHARED, file_descriptor, 0);
+	/* The mapping does not need the file descriptor to remain open. */
+	::close(file_descriptor);
+	if (address != MAP_FAILED)
+	{
+		this->address = static_cast<char const*>(address);
+	}
+}
+
+MappedFile::~MappedFile()
+{
+	if (this->address != nullptr)
+	{
+		::munmap(const_cast<char*>(this->address), this->byte_size);
+	}
+}
+
+std::optional<ChunkSavedData> RegionFile::read_chunk(unsigned int chunk_index,
+	bool memory_mapping)
+{
+	std::lock_guard<std::mutex> lock{this->mutex};
+	ChunkLocation const location = this->location_table[chunk_index];
+	if (location.byte_size == 0)
+	{
+		return std::nullopt;
+	}
+	std::size_t const first_byte = static_cast<std::size_t>(location.first_sector) * SECTOR_SIZE;
+
+	if (memory_mapping)
+	{
+		std::shared_ptr<MappedFile const> mapped_file =
+			this->mapped_file_containing(first_byte + location.byte_size);
+		if (mapped_file != nullptr)
+		{
+			char const* const data = mapped_file->address + first_byte;
+			return ChunkSavedData{std::move(mapped_file), data, location.byte_size};
+		}
+		/* Falling back to reading the file. */
+	}
+
+	auto buffer = std::make_shared<std::vector<char>>(location.byte_size);
+	this->file.seekg(first_byte);
+	this->file.read(buffer->data(), location.byte_size);
+	if (not this->file.good())
+	{
+		this->file.clear();
+		return std::nullopt;
+	}
+	char const* const data = buffer->data();
+	return ChunkSavedData{std::move(buffer), data, location.byte_size};
+}
+
+void RegionFile::write_chunk(unsigned int chunk_index, char const* data, std::uint32_t byte_size)
+{
+	assert(byte_size != 0);
+	std::lock_guard<std::mutex> lock{this->mutex};
+	if (not this->file.is_open())
+	{
+		this->create_file();
+	}
+
+	/* The data is rewritten in place if it fits in the sectors it already has. */
+	ChunkLocation& location = this->location_table[chunk_index];
+	unsigned int const old_sector_count = (location.byte_size + SECTOR_SIZE - 1) / SECTOR_SIZE;
+	unsigned int const new_sector_count = (byte_size + SECTOR_SIZE - 1) / SECTOR_SIZE;
+	if (location.byte_size != 0 && new_sector_count <= old_sector_count)
+	{
+		this->free_sectors(location.first_sector + new_sector_count,
+			old_sector_count - new_sector_count);
+	}
+	else
+	{
+		if (location.byte_size != 0)
+		{
+			this->free_sectors(location.first_sector, old_sector_count);
+		}
+		location.first_sector = this->allocate_sectors(new_sector_count);
+	}
+	location.byte_size = byte_size;
+
+	/* The last sector is padded so that the file always ends at the end of a sector
+	 * (the sectors after it can then be written to without seeking past the end). */
+	static char const padding[SECTOR_SIZE] = {};
+	this->file.seekp(static_cast<std::streamoff>(location.first_sector) * SECTOR_SIZE);
+	this->file.write(data, byte_size);
+	this->file.write(padding, new_sector_count * SECTOR_SIZE - byte_size);
+	this->write_location(chunk_index);
+}
+
+void RegionFile::flush()
+{
+	std::lock_guard<std::mutex> lock{this->mutex};
+	if (this->file.is_open())
+	{
+		this->file.flush();
+	}
+}
+
+void RegionFile::create_file()
+{
+	this->file.open(this->file_name,
+		std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+	if (not this->file.is_open())
+	{
+		std::cout << "\x1b[31mError:\x1b[39m "
+			<< "Failed to create the region file \"" << this->file_name << "\"."
+			<< std::endl;
+		assert(false);
+		std::exit(EXIT_FAILURE);
+	}
+	std::vector<char> header(HEADER_SECTOR_COUNT * SECTOR_SIZE, 0);
+	std::memcpy(header.data(), MAGIC, sizeof MAGIC);
+	std::memcpy(header.data() + sizeof MAGIC, &FORMAT_VERSION, sizeof FORMAT_VERSION);
+	this->file.write(header.data(), header.size());
+}
+
+std::uint32_t RegionFile::allocate_sectors(unsigned int sector_count)
+{
+	unsigned int const total_sector_count = this->sector_is_used_table.size();
+	unsigned int run_length = 0;
+	for (unsigned int i = HEADER_SECTOR_COUNT; i < total_sector_count; i++)
+	{
+		run_length = this->sector_is_used_table[i] ? 0 : run_length + 1;
+		if (run_length == sector_count)
+		{
+			unsigned int const first_sector = i + 1 - sector_count;
+			std::fill(
+				this->sector_is_used_table.begin() + first_sector,
+				this->sector_is_used_table.begin() + i + 1,
+				true);
+			return first_sector;
+		}
+	}
+
+	/* No free run is long enough, the trailing free sectors (if any) are extended. */
+	unsigned int const first_sector = total_sector_count - run_length;
+	this->sector_is_used_table.resize(first_sector + sector_count);
+	std::fill(
+		this->sector_is_used_table.begin() + first_sector,
+		this->sector_is_used_table.end(),
+		true);
+	return first_sector;
+}
+
+void RegionFile::free_sectors(std::uint32_t first_sector, unsigned int sector_count)
+{
+	std::fill(
+		this->sector_is_used_table.begin() + first_sector,
+		this->sector_is_used_table.begin() + first_sector + sector_count,
+		false);
+}
+
+void RegionFile::write_location(unsigned int chunk_index)
+{
+	this->file.seekp(LOCATION_TABLE_OFFSET + chunk_index * sizeof (ChunkLocation));
+	this->file.write(
+		static_cast<char const*>(static_cast<void const*>(&this->location_table[chunk_index])),
+		sizeof (ChunkLocation));
+}
+
+namespace
+{
+
+/* Division that rounds towards negative infinity. */
+int floor_division(int value, int divisor)
+{
+	return value / divisor - (value % divisor < 0 ? 1 : 0);
+}
+
+/* Parses the coords in a file name stem of the form "prefix_x_y_z"
+ * (the prefix including its '_'). */
+std::optional<ChunkCoords> coords_in_file_stem(std::string const& stem,
+	std::string_view prefix)
+{
+	if (stem.rfind(prefix, 0) != 0)
+	{
+		return std::nullopt;
+	}
+	std::stringstream stem_stream{stem.substr(prefix.size())};
+	ChunkCoords coords;
+	char separator_x, separator_y;
+	stem_stream >> coords.x >> separator_x >> coords.y >> separator_y >> coords.z;
+	if (stem_stream.fail() || (not stem_stream.eof()) ||
+		separator_x != '_' || separator_y != '_')
+	{
+		return std::nullopt;
+	}
+	return coords;
+}
+
+} /* Anonymous namespace. */
+
+std::shared_ptr<MappedFile const> RegionFile::mapped_file_containing(std::size_t end_byte)
+{
+	if (this->mapped_file != nullptr && end_byte <= this->mapped_file->byte_size)
+	{
+		return this->mapped_file;
+	}
+
+	/* The whole file is mapped, the data it contains was flushed (see `read_chunk`) so its
+	 * size on the disk is its actual size. Mapping a file of size 0 is not allowed. */
+	std::error_code error_code;
+	std::size_t const file_byte_size = std::filesystem::file_size(this->file_name, error_code);
+	if (error_code || file_byte_size < end_byte || file_byte_size == 0)
+	{
+		return nullptr;
+	}
+	auto new_mapped_file = std::make_shared<MappedFile const>(this->file_name, file_byte_size);
+	if (new_mapped_file->address == nullptr)
+	{
+		return nullptr;
+	}
+	this->mapped_file = std::move(new_mapped_file);
+	return this->mapped_file;
+}
+
+RegionFileTable::RegionFileTable(std::string_view directory):
+	directory{directory},
+	memory_mapping{false}
+{
+	std::filesystem::path const directory_path{directory};
+	if (not std::filesystem::is_directory(directory_path))
+	{
+		return;
+	}
+	for (std::filesystem::directory_entry const& entry :
+		std::filesystem::directory_iterator{directory_path})
+	{
+		std::filesystem::path const& path = entry.path();
+		if ((not entry.is_regular_file()) || path.extension() != ".qwy2_region")
+		{
+			continue;
+		}
+		std::optional<ChunkCoords> const region_coords =
+			coords_in_file_stem(path.stem().string(), "region_");
+		if (not region_coords.has_value())
+		{
+			continue;
+		}
+		std::vector<bool> saved_chunk_table =
+			RegionFile::read_saved_chunk_table(path.string());
+		if (not saved_chunk_table.empty())
+		{
+			this->saved_chunk_index.insert(std::make_pair(
+				region_coords.value(), std::move(saved_chunk_table)));
+		}
+	}
+}
+
+bool RegionFileTable::has_chunk(ChunkCoords chunk_coords) const
+{
+	std::lock_guard<std::mutex> lock{this->saved_chunk_index_mutex};
+	auto const iterator = this->saved_chunk_index.find(region_coords(chunk_coords));
+	return iterator != this->saved_chunk_index.end() &&
+		iterator->second[chunk_index(chunk_coords)];
+}
+
+unsigned int RegionFileTable::saved_chunk_count() const
+{
+	std::lock_guard<std::mutex> lock{this->saved_chunk_index_mutex};
+	unsigned int count = 0;
+	for (auto const& [region_coords, saved_chunk_table] : this->saved_chunk_index)
+	{
+		count += std::count(saved_chunk_table.begin(), saved_chunk_table.end(), true);
+	}
+	return count;
+}
+
+void RegionFileTable::use_memory_mapping(bool memory_mapping)
+{
+	this->memory_mapping = memory_mapping;
+}
+
+std::optional<ChunkSavedData> RegionFileTable::read_chunk(ChunkCoords chunk_coords)
+{
+	return this->region_file_of_chunk(chunk_coords).read_chunk(
+		chunk_index(chunk_coords), this->memory_mapping);
+}
+
+void RegionFileTable::write_chunk(ChunkCoords chunk_coords,
+	char const* data, std::uint32_t byte_size)
+{
+	this->region_file_of_chunk(chunk_coords).write_chunk(
+		chunk_index(chunk_coords), data, byte_size);
+
+	std::lock_guard<std::mutex> lock{this->saved_chunk_index_mutex};
+	std::vector<bool>& saved_chunk_table = this->saved_chunk_index[region_coords(chunk_coords)];
+	if (saved_chunk_table.empty())
+	{
+		saved_chunk_table.resize(RegionFile::CHUNK_COUNT, false);
+	}
+	saved_chunk_table[chunk_index(chunk_coords)] = true;
+}
+
+void RegionFileTable::flush()
+{
+	std::lock_guard<std::mutex> lock{this->mutex};
+	for (auto& [region_coords, region_file] : this->region_file_table)
+	{
+		region_file->flush();
+	}
+}
+
+RegionFile& RegionFileTable::region_file_of_chunk(ChunkCoords chunk_coords)
+{
+	ChunkCoords const region_coords = RegionFileTable::region_coords(chunk_coords);
+	std::lock_guard<std::mutex> lock{this->mutex};
+	auto iterator = this->region_file_table.find(region_coords);
+	if (iterator == this->region_file_table.end())
+	{
+		std::stringstream file_name_stream;
+		file_name_stream << this->directory << "region_"
+			<< region_coords.x << "_" << region_coords.y << "_" << region_coords.z
+			<< ".qwy2_region";
+		iterator = this->region_file_table.insert(std::make_pair(region_coords,
+			std::make_unique<RegionFile>(file_name_stream.str()))).first;
+	}
+	return *iterator->second;
+}
+
+ChunkCoords RegionFileTable::region_coords(ChunkCoords chunk_coords)
+{
+	return ChunkCoords{
+		floor_division(chunk_coords.x, RegionFile::SIDE),
+		floor_division(chunk_coords.y, RegionFile::SIDE),
+		floor_division(chunk_coords.z, RegionFile::SIDE)};
+}
+
+unsigned int RegionFileTable::chunk_index(ChunkCoords chunk_coords)
+{
+	int const side = RegionFile::SIDE;
+	return
+		(chunk_coords.x - floor_division(chunk_coords.x, side) * side) +
+		(chunk_coords.y - floor_division(chunk_coords.y, side) * side) * side +
+		(chunk_coords.z - floor_division(chunk_coords.z, side) * side) * side * side;
+}
+
+unsigned int convert_chunk_files_to_region_files(std::string_view directory,
+	RegionFileTable& region_file_table)
+{
+	std::filesystem::path const directory_path{directory};
+	if (not std::filesystem::is_directory(directory_path))
+	{
+		return 0;
+	}
+
+	unsigned int converted_count = 0;
+	std::vector<std::filesystem::path> converted_path_table;
+	for (std::filesystem::directory_entry const& entry :
+		std::filesystem::directory_iterator{directory_path})
+	{
+		/* The old chunk files are named "chunk_x_y_z.qwy2_chunk". */
+		std::filesystem::path const& path = entry.path();
+		if ((not entry.is_regular_file()) || path.extension() != ".qwy2_chunk")
+		{
+			continue;
+		}
+		std::optional<ChunkCoords> const chunk_coords =
+			coords_in_file_stem(path.stem().string(), "chunk_");
+		if (not chunk_coords.has_value())
+		{
+			continue;
+		}
+
+		std::ifstream file{path, std::ios::binary};
+		std::vector<char> const data{
+			std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+		if (data.empty())
+		{
+			continue;
+		}
+		region_file_table.write_chunk(chunk_coords.value(), data.data(), data.size());
+		converted_path_table.push_back(path);
+		converted_count++;
+	}
+
+	/* The old files are only removed once they were all converted. */
+	region_file_table.flush();
+	for (std::filesystem::path const& path : converted_path_table)
+	{
+		std::filesystem::remove(path);
+	}
+	return converted_count;
+}
+
+} /* qwy2 */
@@ -0,0 +1,190 @@
+
+#ifndef QWY2_HEADER_REGION_
+#define QWY2_HEADER_REGION_
+
+#include "coords.hpp"
+#include <vector>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <mutex>
+#include <memory>
+#include <unordered_map>
+#include <optional>
+#include <cstddef>
+#include <cstdint>
+
+namespace qwy2
+{
+
+/* A read-only memory mapping of (the beginning of) a file, unmapped on destruction. */
+class MappedFile
+{
+public:
+	char const* address;
+	std::size_t byte_size;
+
+public:
+	/* Maps the first `byte_size` bytes of the given file, which must be at least that big,
+	 * `address` is null if that failed. */
+	MappedFile(std::string const& file_name, std::size_t byte_size);
+	~MappedFile();
+	MappedFile(MappedFile const&) = delete;
+	MappedFile& operator=(MappedFile const&) = delete;
+};
+
+/* The saved data of a chunk, read from a region file. It either points in a memory mapping
+ * of the region file or in a buffer it was read into, that it keeps alive in both cases. */
+class ChunkSavedData
+{
+public:
+	std::shared_ptr<void const> owner;
+	char const* data;
+	std::uint32_t byte_size;
+};
+
+/* A region file holds the saved data of all the chunks of a cube of `SIDE`^3 chunks,
+ * so that saving a big world does not make for a huge number of tiny files, and so that
+ * accessing the saved data of a chunk is just a seek in an already open file
+ * (or an access to a memory mapping of the file).
+ * The file starts with a header that gives the location of the data of each chunk
+ * in the file, and the data of the chunks is stored in sectors (of `SECTOR_SIZE` bytes)
+ * that follow the header. The data of a chunk is rewritten in place if it still fits in
+ * its sectors, else it is moved to the first free sectors that fit (or at the end).
+ * The file is only created when some chunk data is first written to it.
+ * All the methods can be called concurrently by different threads. */
+class RegionFile
+{
+public:
+	/* The number of chunks along each edge of the cube of chunks of a region. */
+	static constexpr int SIDE = 16;
+	static constexpr unsigned int CHUNK_COUNT = SIDE * SIDE * SIDE;
+	static constexpr unsigned int SECTOR_SIZE = 4096;
+
+private:
+	/* Where the data of a chunk is in the file, a size of 0 means there is no data. */
+	class ChunkLocation
+	{
+	public:
+		std::uint32_t first_sector;
+		std::uint32_t byte_size;
+	};
+
+	/* The header is the magic bytes, the format version, some reserved bytes,
+	 * and then the location of each chunk, with the integers in native byte order. */
+	static constexpr char MAGIC[8] = {'Q', 'w', 'y', '2', 'R', 'g', 'n', '\0'};
+	static constexpr std::uint32_t FORMAT_VERSION = 1;
+	static constexpr unsigned int LOCATION_TABLE_OFFSET = 16;
+	static constexpr unsigned int HEADER_BYTE_SIZE =
+		LOCATION_TABLE_OFFSET + CHUNK_COUNT * sizeof (ChunkLocation);
+	static constexpr unsigned int HEADER_SECTOR_COUNT =
+		(HEADER_BYTE_SIZE + SECTOR_SIZE - 1) / SECTOR_SIZE;
+
+	std::string file_name;
+	std::mutex mutex;
+	/* Only open if the file exists. */
+	std::fstream file;
+	/* Null as long as no chunk is read with memory mapping, and remapped when a chunk to read
+	 * is beyond its end (after the file got bigger). The readers of the old mapping keep it
+	 * alive as long as they need it. */
+	std::shared_ptr<MappedFile const> mapped_file;
+	/* Indexed by the chunk indices (see `RegionFileTable::chunk_index`). */
+	std::vector<ChunkLocation> location_table;
+	/* Indexed by the sectors of the file (the header sectors count as used). */
+	std::vector<bool> sector_is_used_table;
+
+public:
+	/* Reads the header of the file if it exists. */
+	RegionFile(std::string file_name);
+
+	/* Reads only the header of the given region file and tells which of its chunks have
+	 * some saved data (indexed by chunk indices), returns an empty table if it is not
+	 * a valid region file. */
+	static std::vector<bool> read_saved_chunk_table(std::string const& file_name);
+
+	/* Returns the data of the given chunk, or nothing if there is no data for this chunk.
+	 * With memory mapping the data is not copied (nor read until it is accessed).
+	 * Data written after the last call to `flush` may not be visible to memory mapping. */
+	std::optional<ChunkSavedData> read_chunk(unsigned int chunk_index, bool memory_mapping);
+
+	/* The written data may not be on the disk before a call to `flush`. */
+	void write_chunk(unsigned int chunk_index, char const* data, std::uint32_t byte_size);
+	void flush();
+
+private:
+	/* Creates the file with an empty header. */
+	void create_file();
+
+	/* Returns the first sector of a run of free sectors of the given length
+	 * (that are marked as used), possibly at the end of the file. */
+	std::uint32_t allocate_sectors(unsigned int sector_count);
+	void free_sectors(std::uint32_t first_sector, unsigned int sector_count);
+
+	/* Writes the location of the given chunk in the header of the file. */
+	void write_location(unsigned int chunk_index);
+
+	/* Returns a mapping of the file that contains the given range of bytes of the file,
+	 * or null if the file could not be mapped. */
+	std::shared_ptr<MappedFile const> mapped_file_containing(std::size_t end_byte);
+};
+
+/* The region files of a save directory, they are opened when first needed
+ * and remain open. Which chunks are saved is known for the whole directory from the start
+ * (the headers of the region files are all read by the constructor) and kept up to date
+ * by the writes, so telling if a chunk is saved never touches the disk.
+ * All the methods can be called concurrently by different threads. */
+class RegionFileTable
+{
+private:
+	/* The directory (with a trailing '/') in which the region files are to be found. */
+	std::string directory;
+	std::mutex mutex;
+	/* Indexed by region coords (which are the chunk coords divided by `RegionFile::SIDE`). */
+	std::unordered_map<ChunkCoords, std::unique_ptr<RegionFile>, ChunkCoords::Hash>
+		region_file_table;
+
+	/* If true then the region files are read through memory mappings instead of reads. */
+	bool memory_mapping;
+
+	mutable std::mutex saved_chunk_index_mutex;
+	/* Indexed by region coords, then by chunk indices. A region that is not in there
+	 * has no saved chunk. */
+	std::unordered_map<ChunkCoords, std::vector<bool>, ChunkCoords::Hash> saved_chunk_index;
+
+public:
+	/* Builds the index of the saved chunks from the region files in the given directory
+	 * (that may not exist yet). */
+	RegionFileTable(std::string_view directory);
+
+	/* Does not access the disk. */
+	bool has_chunk(ChunkCoords chunk_coords) const;
+	unsigned int saved_chunk_count() const;
+
+	/* Must be called before reading any chunk. */
+	void use_memory_mapping(bool memory_mapping);
+
+	std::optional<ChunkSavedData> read_chunk(ChunkCoords chunk_coords);
+	void write_chunk(ChunkCoords chunk_coords, char const* data, std::uint32_t byte_size);
+
+	/* Flushes all the open region files. */
+	void flush();
+
+	/* The coords of the region that contains the given chunk. */
+	static ChunkCoords region_coords(ChunkCoords chunk_coords);
+
+	/* The index of the given chunk in the region that contains it. */
+	static unsigned int chunk_index(ChunkCoords chunk_coords);
+
+private:
+	RegionFile& region_file_of_chunk(ChunkCoords chunk_coords);
+};
+
+/* Moves the data of the chunks that are saved with the old layout (one file per chunk,
+ * named "chunk_x_y_z.qwy2_chunk") in the given directory into the given region files,
+ * and removes the old files. Returns the number of converted chunks. */
+unsigned int convert_chunk_files_to_region_files(std::string_view directory,
+	RegionFileTable& region_file_table);
+
+} /* qwy2 */
+
+#endif /* QWY2_HEADER_REGION_ */
@@ -0,0 +1,101 @@
+
+#include "chunk.hpp"
+#include "embedded.hpp"
+#include "mesh.hpp"
+#include "nature.hpp"
+#include <glm/vec4.hpp>
+#include <cassert>
+#include <cstddef>
+
+namespace qwy2
+{
+
+VertexDataChunk::VertexDataChunk(
+	unsigned int local_x, unsigned int local_y, unsigned int local_z,
+	unsigned int face_id, unsigned int ambiant_occlusion, std::uint16_t block_type_id
+):
+	coords_face_ambiant_occlusion{
+		local_x |
+		(local_y << 8) |
+		(local_z << 16) |
+		(face_id << 24) |
+		(ambiant_occlusion << 27)},
+	block_type_id{block_type_id}
+{
+	assert(local_x <= VertexDataChunk::LOCAL_COORD_MAX);
+	assert(local_y <= VertexDataChunk::LOCAL_COORD_MAX);
+	assert(local_z <= VertexDataChunk::LOCAL_COORD_MAX);
+	assert(face_id < 6);
+	assert(ambiant_occlusion <= 3);
+}
+
+ErrorCode ShaderProgramChunk::init()
+{
+	return this->compile_given_src(
+		g_shader_source_chunk_vert,
+		nullptr,
+		g_shader_source_chunk_frag,
+		"chunk vert", nullptr, "chunk frag", "chunk");
+}
+
+void ShaderProgramChunk::draw(Mesh<VertexDataChunk> const& mesh, glm::vec3 chunk_origin_coords)
+{
+	glUseProgram(this->openglid);
+	glUniform3f(11, chunk_origin_coords.x, chunk_origin_coords.y, chunk_origin_coords.z);
+
+	constexpr unsigned int vertex_attrib_number = 2;
+	for (unsigned int i = 0; i < vertex_attrib_number; i++)
+	{
+		glEnableVertexAttribArray(i);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, mesh.openglid);
+	unsigned int attrib_index = 0;
+	glVertexAttribIPointer(attrib_index++, 1, GL_UNSIGNED_INT, sizeof(VertexDataChunk),
+		reinterpret_cast<void*>(offsetof(VertexDataChunk, coords_face_ambiant_occlusion)));
+	glVertexAttribIPointer(attrib_index++, 1, GL_UNSIGNED_INT, sizeof(VertexDataChunk),
+		reinterpret_cast<void*>(offsetof(VertexDataChunk, block_type_id)));
+	assert(attrib_index == vertex_attrib_number);
+
+	unsigned int const quad_count = mesh.vertex_data.size() / 4;
+	bind_quad_index_buffer(quad_count);
+	glDrawElements(GL_TRIANGLES, quad_count * 6, GL_UNSIGNED_INT, nullptr);
+
+	for (unsigned int i = 0; i < vertex_attrib_number; i++)
+	{
+		glDisableVertexAttribArray(i);
+	}
+}
+
+void ShaderProgramChunk::update_block_type_table(std::vector<BlockType> const& block_type_table)
+{
+	/* Matches the `BlockTypeAtlasRects` struct of the shaders (with the std430 layout),
+	 * each rect is a vec4 with the min coords in xy and the max coords in zw. */
+	std::vector<glm::vec4> rect_table;
+	rect_table.reserve(block_type_table.size() * 3);
+	for (BlockType const& block_type : block_type_table)
+	{
+		for (AtlasRect const& rect :
+			{block_type.fase_top_rect, block_type.fase_vertical_rect, block_type.fase_bottom_rect})
+		{
+			rect_table.push_back(glm::vec4{
+				rect.atlas_coords_min.x, rect.atlas_coords_min.y,
+				rect.atlas_coords_max.x, rect.atlas_coords_max.y});
+		}
+	}
+
+	if (this->block_type_table_openglid == 0)
+	{
+		glGenBuffers(1, &this->block_type_table_openglid);
+		assert(this->block_type_table_openglid != 0);
+	}
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, this->block_type_table_openglid);
+	glBufferData(GL_SHADER_STORAGE_BUFFER,
+		rect_table.size() * sizeof(glm::vec4),
+		rect_table.data(),
+		GL_STATIC_DRAW);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER,
+		ShaderProgramChunk::BLOCK_TYPE_TABLE_BINDING, this->block_type_table_openglid);
+}
+
+} /* qwy2 */
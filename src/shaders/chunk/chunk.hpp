@@ -0,0 +1,70 @@
+
+#ifndef QWY2_HEADER_CHUNK_SHADER_
+#define QWY2_HEADER_CHUNK_SHADER_
+
+#include "shaders/shader.hpp"
+#include "shaders/classic/classic.hpp"
+#include <vector>
+#include <cstdint>
+
+namespace qwy2
+{
+
+/* Data held by one vertex in a chunk mesh, packed in 8 bytes.
+ * Chunk meshes are made of quads of 4 vertices (see `bind_quad_index_buffer`).
+ * Instead of world coords, the vertex has coords relative to the most negativeward corner of its
+ * chunk (the chunk origin coords are given to the shader for each chunk mesh), and instead of
+ * atlas coords, it has the block type id of its face (the atlas rects of all the block types
+ * are given to the shader in a table, see `ShaderProgramChunk::update_block_type_table`). */
+class VertexDataChunk
+{
+public:
+	/* Bits 0-7, 8-15 and 16-23 are the x, y and z chunk-local coords of the vertex.
+	 * Bits 24-26 are the face id (the axis index times 2, plus 1 if the face is negativeward).
+	 * Bits 27-28 are the ambiant occlusion (from 0 for the darkest to 3 for none at all). */
+	std::uint32_t coords_face_ambiant_occlusion;
+	std::uint32_t block_type_id;
+
+public:
+	/* The biggest value a chunk-local coordinate can have,
+	 * which limits the chunk side to this value. */
+	static constexpr unsigned int LOCAL_COORD_MAX = 255;
+
+public:
+	VertexDataChunk(
+		unsigned int local_x, unsigned int local_y, unsigned int local_z,
+		unsigned int face_id, unsigned int ambiant_occlusion, std::uint16_t block_type_id);
+};
+
+static_assert(sizeof(VertexDataChunk) == 8);
+
+template<typename VertexDataType>
+class Mesh;
+
+class BlockType;
+
+/* Variant of the classic shader program that renders chunk meshes made of `VertexDataChunk`s.
+ * It uses the same uniforms at the same locations as the classic shader program,
+ * plus the coords of the origin of the drawn chunk mesh that are given to `draw`. */
+class ShaderProgramChunk: public ShaderProgramClassic
+{
+public:
+	/* The OpenGL buffer with the atlas rects of the block types, read by both the chunk
+	 * shader program and the chunk shadow shader program via the shader storage buffer
+	 * binding point `BLOCK_TYPE_TABLE_BINDING`. */
+	GLuint block_type_table_openglid = 0;
+	static constexpr GLuint BLOCK_TYPE_TABLE_BINDING = 0;
+
+public:
+	virtual ErrorCode init() override;
+	void draw(Mesh<VertexDataChunk> const& mesh, glm::vec3 chunk_origin_coords);
+
+	/* Uploads the atlas rects of the given block types (indexed by block type id)
+	 * and binds the buffer to `BLOCK_TYPE_TABLE_BINDING`.
+	 * Must be called again if the block type table is modified. */
+	void update_block_type_table(std::vector<BlockType> const& block_type_table);
+};
+
+} /* qwy2 */
+
+#endif /* QWY2_HEADER_CHUNK_SHADER_ */
@@ -0,0 +1,78 @@
+
+#version 430 core
+
+layout(location = 0) in uint in_coords_face_ambient_occlusion;
+layout(location = 1) in uint in_block_type_id;
+
+layout(location = 0) uniform mat4 u_user_camera;
+layout(location = 2) uniform mat4 u_sun_camera;
+layout(location = 11) uniform vec3 u_chunk_origin_coords;
+
+/* The atlas rects have their min coords in xy and their max coords in zw. */
+struct BlockTypeAtlasRects
+{
+	vec4 top;
+	vec4 vertical;
+	vec4 bottom;
+};
+layout(std430, binding = 0) readonly buffer BlockTypeTable
+{
+	BlockTypeAtlasRects block_type_table[];
+};
+
+out vec2 v_atlas_coords;
+flat out vec2 v_atlas_coords_min;
+flat out vec2 v_atlas_coords_max;
+out vec3 v_normal;
+out vec3 v_sun_camera_space_coords;
+out vec3 v_coords;
+out float v_ambient_occlusion;
+
+void main()
+{
+	/* Unpacking, see `VertexDataChunk`. */
+	const vec3 local_coords = vec3(
+		float(in_coords_face_ambient_occlusion & 255u),
+		float((in_coords_face_ambient_occlusion >> 8u) & 255u),
+		float((in_coords_face_ambient_occlusion >> 16u) & 255u));
+	const uint face_id = (in_coords_face_ambient_occlusion >> 24u) & 7u;
+	const uint axis = face_id >> 1u;
+	const bool negativeward = (face_id & 1u) != 0u;
+	const uint ambient_occlusion = (in_coords_face_ambient_occlusion >> 27u) & 3u;
+
+	const vec3 coords = u_chunk_origin_coords + local_coords;
+	gl_Position = u_user_camera * vec4(coords, 1.0);
+
+	/* The atlas coords are given in faces, and the fragment shader only keeps their fractional
+	 * part (so that faces merged by greedy meshing repeat the texture). Some are negated
+	 * to get the textures to be oriented as expected on each face. */
+	const uint index_a = axis == 0u ? 1u : 0u;
+	const uint index_b = axis == 2u ? 1u : 2u;
+	v_atlas_coords = vec2(local_coords[index_a], local_coords[index_b]);
+	if ((axis == 1u && !negativeward) || (axis == 0u && negativeward))
+	{
+		v_atlas_coords.x = -v_atlas_coords.x;
+	}
+	if (axis == 0u || axis == 1u)
+	{
+		v_atlas_coords.y = -v_atlas_coords.y;
+	}
+	const BlockTypeAtlasRects rects = block_type_table[in_block_type_id];
+	const vec4 rect = axis == 2u ? (negativeward ? rects.bottom : rects.top) : rects.vertical;
+	v_atlas_coords_min = rect.xy;
+	v_atlas_coords_max = rect.zw;
+
+	v_normal = vec3(0.0, 0.0, 0.0);
+	v_normal[axis] = negativeward ? -1.0 : 1.0;
+
+	/* Coords of the vertex in the sun camera space,
+	 * and then in the shadow depth buffer space (0.0 ~ 1.0 instead of -1.0 ~ +1.0),
+	 * to compare the fragment depths to their shadow depth buffer analog. */
+	vec4 sun_coords = u_sun_camera * vec4(coords, 1.0);
+	v_sun_camera_space_coords = sun_coords.xyz / sun_coords.w;
+	v_sun_camera_space_coords.xyz = (v_sun_camera_space_coords.xyz + 1.0) / 2.0;
+
+	v_coords = coords;
+
+	v_ambient_occlusion = float(ambient_occlusion) / 3.0;
+}
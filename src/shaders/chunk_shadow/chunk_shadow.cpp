@@ -0,0 +1,51 @@
+
+#include "chunk_shadow.hpp"
+#include "shaders/chunk/chunk.hpp"
+#include "mesh.hpp"
+#include "embedded.hpp"
+#include <cassert>
+#include <cstddef>
+
+namespace qwy2
+{
+
+ErrorCode ShaderProgramChunkShadow::init()
+{
+	return this->compile_given_src(
+		g_shader_source_chunk_shadow_vert,
+		nullptr,
+		g_shader_source_chunk_shadow_frag,
+		"chunk shadow vert", nullptr, "chunk shadow frag", "chunk shadow");
+}
+
+void ShaderProgramChunkShadow::draw(
+	Mesh<VertexDataChunk> const& mesh, glm::vec3 chunk_origin_coords)
+{
+	glUseProgram(this->openglid);
+	glUniform3f(2, chunk_origin_coords.x, chunk_origin_coords.y, chunk_origin_coords.z);
+
+	constexpr unsigned int vertex_attrib_number = 2;
+	for (unsigned int i = 0; i < vertex_attrib_number; i++)
+	{
+		glEnableVertexAttribArray(i);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, mesh.openglid);
+	unsigned int attrib_index = 0;
+	glVertexAttribIPointer(attrib_index++, 1, GL_UNSIGNED_INT, sizeof(VertexDataChunk),
+		reinterpret_cast<void*>(offsetof(VertexDataChunk, coords_face_ambiant_occlusion)));
+	glVertexAttribIPointer(attrib_index++, 1, GL_UNSIGNED_INT, sizeof(VertexDataChunk),
+		reinterpret_cast<void*>(offsetof(VertexDataChunk, block_type_id)));
+	assert(attrib_index == vertex_attrib_number);
+
+	unsigned int const quad_count = mesh.vertex_data.size() / 4;
+	bind_quad_index_buffer(quad_count);
+	glDrawElements(GL_TRIANGLES, quad_count * 6, GL_UNSIGNED_INT, nullptr);
+
+	for (unsigned int i = 0; i < vertex_attrib_number; i++)
+	{
+		glDisableVertexAttribArray(i);
+	}
+}
+
+} /* qwy2 */
@@ -0,0 +1,23 @@
+
+#version 430 core
+
+in vec2 v_atlas_coords;
+flat in vec2 v_atlas_coords_min;
+flat in vec2 v_atlas_coords_max;
+
+layout(location = 1) uniform sampler2D u_atlas;
+
+void main()
+{
+	/* Here there is no need to carefully avoid atlas bleeding it seems. */
+
+	vec4 out_color = texture(u_atlas,
+		mix(v_atlas_coords_min, v_atlas_coords_max, fract(v_atlas_coords)));
+	if (out_color.a < 0.001)
+	{
+		discard;
+	}
+
+	/* We only checked for transparent `out_color`, but we then do nothing with it
+	 * as the only thing we care about is the Z-buffer. */
+}
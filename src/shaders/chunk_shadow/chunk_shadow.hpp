@@ -0,0 +1,27 @@
+
+#ifndef QWY2_HEADER_CHUNK_SHADOW_SHADER_
+#define QWY2_HEADER_CHUNK_SHADOW_SHADER_
+
+#include "shaders/shader.hpp"
+#include "shaders/shadow/shadow.hpp"
+
+namespace qwy2
+{
+
+class VertexDataChunk;
+
+template<typename VertexDataType>
+class Mesh;
+
+/* Same as the `shadow` shader, but with `VertexDataChunk` instead of `VertexDataClassic`.
+ * It reads the block type table set by `ShaderProgramChunk::update_block_type_table`. */
+class ShaderProgramChunkShadow: public ShaderProgramShadow
+{
+public:
+	virtual ErrorCode init() override;
+	void draw(Mesh<VertexDataChunk> const& mesh, glm::vec3 chunk_origin_coords);
+};
+
+} /* qwy2 */
+
+#endif /* QWY2_HEADER_CHUNK_SHADOW_SHADER_ */
@@ -0,0 +1,54 @@
+
+#version 430 core
+
+layout(location = 0) in uint in_coords_face_ambient_occlusion;
+layout(location = 1) in uint in_block_type_id;
+
+layout(location = 0) uniform mat4 sun_camera;
+layout(location = 2) uniform vec3 u_chunk_origin_coords;
+
+/* Same as in the chunk shader. */
+struct BlockTypeAtlasRects
+{
+	vec4 top;
+	vec4 vertical;
+	vec4 bottom;
+};
+layout(std430, binding = 0) readonly buffer BlockTypeTable
+{
+	BlockTypeAtlasRects block_type_table[];
+};
+
+out vec2 v_atlas_coords;
+flat out vec2 v_atlas_coords_min;
+flat out vec2 v_atlas_coords_max;
+
+void main()
+{
+	/* Unpacking, see `VertexDataChunk` and the chunk shader. */
+	const vec3 local_coords = vec3(
+		float(in_coords_face_ambient_occlusion & 255u),
+		float((in_coords_face_ambient_occlusion >> 8u) & 255u),
+		float((in_coords_face_ambient_occlusion >> 16u) & 255u));
+	const uint face_id = (in_coords_face_ambient_occlusion >> 24u) & 7u;
+	const uint axis = face_id >> 1u;
+	const bool negativeward = (face_id & 1u) != 0u;
+
+	gl_Position = sun_camera * vec4(u_chunk_origin_coords + local_coords, 1.0);
+
+	const uint index_a = axis == 0u ? 1u : 0u;
+	const uint index_b = axis == 2u ? 1u : 2u;
+	v_atlas_coords = vec2(local_coords[index_a], local_coords[index_b]);
+	if ((axis == 1u && !negativeward) || (axis == 0u && negativeward))
+	{
+		v_atlas_coords.x = -v_atlas_coords.x;
+	}
+	if (axis == 0u || axis == 1u)
+	{
+		v_atlas_coords.y = -v_atlas_coords.y;
+	}
+	const BlockTypeAtlasRects rects = block_type_table[in_block_type_id];
+	const vec4 rect = axis == 2u ? (negativeward ? rects.bottom : rects.top) : rects.vertical;
+	v_atlas_coords_min = rect.xy;
+	v_atlas_coords_max = rect.zw;
+}
@@ -16,6 +16,8 @@ ErrorCode ShaderTable::init()
 	this->table[count++, ShaderTable::LINE_UI] = new ShaderProgramLineUi{};
 	this->table[count++, ShaderTable::SIMPLE] = new ShaderProgramSimple{};
 	this->table[count++, ShaderTable::SIMPLE_SHADOW] = new ShaderProgramSimpleShadow{};
+	this->table[count++, ShaderTable::CHUNK] = new ShaderProgramChunk{};
+	this->table[count++, ShaderTable::CHUNK_SHADOW] = new ShaderProgramChunkShadow{};
 	assert(count == ShaderTable::SHADER_COUNT);
 
 	/* Compile all the shaders. */
@@ -69,4 +71,14 @@ ShaderProgramSimpleShadow& ShaderTable::simple_shadow()
 	return *dynamic_cast<ShaderProgramSimpleShadow*>(this->table[ShaderTable::SIMPLE_SHADOW]);
 }
 
+ShaderProgramChunk& ShaderTable::chunk()
+{
+	return *dynamic_cast<ShaderProgramChunk*>(this->table[ShaderTable::CHUNK]);
+}
+
+ShaderProgramChunkShadow& ShaderTable::chunk_shadow()
+{
+	return *dynamic_cast<ShaderProgramChunkShadow*>(this->table[ShaderTable::CHUNK_SHADOW]);
+}
+
 } /* qwy2 */
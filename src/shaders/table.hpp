@@ -10,6 +10,8 @@
 #include "shaders/line_ui/line_ui.hpp"
 #include "shaders/simple/simple.hpp"
 #include "shaders/simple_shadow/simple_shadow.hpp"
+#include "shaders/chunk/chunk.hpp"
+#include "shaders/chunk_shadow/chunk_shadow.hpp"
 #include <vector>
 
 namespace qwy2
@@ -31,6 +33,8 @@ public:
 		LINE_UI,
 		SIMPLE,
 		SIMPLE_SHADOW,
+		CHUNK,
+		CHUNK_SHADOW,
 		SHADER_COUNT,
 	};
 
@@ -50,6 +54,8 @@ public:
 	ShaderProgramLineUi& line_ui();
 	ShaderProgramSimple& simple();
 	ShaderProgramSimpleShadow& simple_shadow();
+	ShaderProgramChunk& chunk();
+	ShaderProgramChunkShadow& chunk_shadow();
 };
 
 } /* qwy2 */
@@ -82,8 +82,9 @@ PlaceBlock::PlaceBlock(BlockTypeId block_type_id, bool only_in_air):
 
 void PlaceBlock::perform(StructureGenerationContext& context) const
 {
+	ChunkBField const& target_b_field = context.target_b_field;
 	if (context.bound_rect.contains(context.head) &&
-		chunk_block_rect(context.target_b_field.chunk_coords).contains(context.head))
+		target_b_field.geometry.block_rect(target_b_field.chunk_coords).contains(context.head))
 	{
 		if ((this->only_in_air && context.target_b_field[context.head].is_air()) ||
 			(not this->only_in_air))
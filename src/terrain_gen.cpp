@@ -6,10 +6,10 @@ namespace qwy2
 {
 
 ChunkPtgField PlainTerrainGeneratorFlat::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		ptg_field[coords] = (coords.z <= 0) ? 1 : 0;
 	}
@@ -17,10 +17,10 @@ ChunkPtgField PlainTerrainGeneratorFlat::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorClassic::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		float const value = nature.world_generator.noise_generator.base_noise(
 			static_cast<float>(coords.x) / nature.world_generator.noise_size,
@@ -38,10 +38,10 @@ ChunkPtgField PlainTerrainGeneratorClassic::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorHills::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		float const value = nature.world_generator.noise_generator.base_noise(
 			static_cast<float>(coords.x) / nature.world_generator.noise_size,
@@ -52,10 +52,10 @@ ChunkPtgField PlainTerrainGeneratorHills::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorHomogenous::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		float const value = nature.world_generator.noise_generator.base_noise(
 			static_cast<float>(coords.x) / nature.world_generator.noise_size,
@@ -67,10 +67,10 @@ ChunkPtgField PlainTerrainGeneratorHomogenous::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorPlane::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		float const value = nature.world_generator.noise_generator.base_noise(
 			static_cast<float>(coords.x) / nature.world_generator.noise_size,
@@ -84,10 +84,10 @@ ChunkPtgField PlainTerrainGeneratorPlane::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorPlanes::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		float const value = nature.world_generator.noise_generator.base_noise(
 			static_cast<float>(coords.x) / nature.world_generator.noise_size,
@@ -102,10 +102,10 @@ ChunkPtgField PlainTerrainGeneratorPlanes::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorVerticalPillar::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		float const value = nature.world_generator.noise_generator.base_noise(
 			static_cast<float>(coords.x) / nature.world_generator.noise_size,
@@ -119,10 +119,10 @@ ChunkPtgField PlainTerrainGeneratorVerticalPillar::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorVerticalHole::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		float const value = nature.world_generator.noise_generator.base_noise(
 			static_cast<float>(coords.x) / nature.world_generator.noise_size,
@@ -136,10 +136,10 @@ ChunkPtgField PlainTerrainGeneratorVerticalHole::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorHorizontalPillar::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		float const value = nature.world_generator.noise_generator.base_noise(
 			static_cast<float>(coords.x) / nature.world_generator.noise_size,
@@ -153,10 +153,10 @@ ChunkPtgField PlainTerrainGeneratorHorizontalPillar::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorHorizontalHole::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		float const value = nature.world_generator.noise_generator.base_noise(
 			static_cast<float>(coords.x) / nature.world_generator.noise_size,
@@ -170,10 +170,10 @@ ChunkPtgField PlainTerrainGeneratorHorizontalHole::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorFunky1::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		glm::vec3 d;
 		for (int i = 0; i < 3; i++)
@@ -200,10 +200,10 @@ ChunkPtgField PlainTerrainGeneratorFunky1::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorFunky2::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		glm::vec3 d;
 		for (int i = 0; i < 3; i++)
@@ -234,10 +234,10 @@ ChunkPtgField PlainTerrainGeneratorFunky2::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorOctaves1::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		constexpr unsigned int octave_number = 4;
 		float value_sum = 0.0f, coef_sum = 0.0f;
@@ -261,10 +261,10 @@ ChunkPtgField PlainTerrainGeneratorOctaves1::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorOctaves2::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		float const noise_size = nature.world_generator.noise_size * 2.5f;
 		constexpr unsigned int octave_number = 4;
@@ -290,7 +290,7 @@ ChunkPtgField PlainTerrainGeneratorOctaves2::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorNoiseTest1::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
 	/* TODO: Make a real function out of this. */
 	auto octaved_noise = [&](BlockCoords coords, int channel)
@@ -315,8 +315,8 @@ ChunkPtgField PlainTerrainGeneratorNoiseTest1::generate_chunk_ptg_field(
 		return value;
 	};
 
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		float const value = octaved_noise(coords, 1);
 		ptg_field[coords] = (0.48f <= value && value <= 0.52f) ? 1 : 0;
@@ -325,7 +325,7 @@ ChunkPtgField PlainTerrainGeneratorNoiseTest1::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorNoiseTest2::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
 	/* TODO: Make a real function out of this. */
 	auto octaved_noise = [&](BlockCoords coords, int channel)
@@ -350,8 +350,8 @@ ChunkPtgField PlainTerrainGeneratorNoiseTest2::generate_chunk_ptg_field(
 		return value;
 	};
 
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		float const value_a = octaved_noise(coords, 1);
 		float const value_b = octaved_noise(coords, 2);
@@ -366,7 +366,7 @@ ChunkPtgField PlainTerrainGeneratorNoiseTest2::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorNoiseTest3::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
 	/* TODO: Make a real function out of this. */
 	auto octaved_noise = [&](BlockCoords coords, int channel, float noise_size_factor)
@@ -391,8 +391,8 @@ ChunkPtgField PlainTerrainGeneratorNoiseTest3::generate_chunk_ptg_field(
 		return value;
 	};
 
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		float const value_a = octaved_noise(coords, 1, 1.0f);
 		float const value_b = octaved_noise(coords, 2, 1.0f);
@@ -408,7 +408,7 @@ ChunkPtgField PlainTerrainGeneratorNoiseTest3::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorNoiseTest4::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
 	/* TODO: Make a real function out of this. */
 	auto octaved_noise = [&](BlockCoords coords, int channel, float noise_size_factor)
@@ -433,8 +433,8 @@ ChunkPtgField PlainTerrainGeneratorNoiseTest4::generate_chunk_ptg_field(
 		return value;
 	};
 
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		BlockCoords coords_but_flatter = coords;
 		coords_but_flatter.z *= 10.0f;
@@ -453,7 +453,7 @@ ChunkPtgField PlainTerrainGeneratorNoiseTest4::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorCaves1::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
 	/* TODO: Make a real function out of this. */
 	auto octaved_noise = [&](BlockCoords coords, int channel)
@@ -478,8 +478,8 @@ ChunkPtgField PlainTerrainGeneratorCaves1::generate_chunk_ptg_field(
 		return value;
 	};
 
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		if (coords.z > 0)
 		{
@@ -501,7 +501,7 @@ ChunkPtgField PlainTerrainGeneratorCaves1::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorBimodalHills::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
 	/* TODO: Make a real function out of this. */
 	auto octaved_noise = [&](BlockCoords coords, int channel)
@@ -547,8 +547,8 @@ ChunkPtgField PlainTerrainGeneratorBimodalHills::generate_chunk_ptg_field(
 		}
 	};
 
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		BlockCoords coords_xy = coords;
 		coords_xy.z = 0;
@@ -566,10 +566,10 @@ ChunkPtgField PlainTerrainGeneratorBimodalHills::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorLameBiomes1::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		glm::vec3 d;
 		for (int i = 0; i < 3; i++)
@@ -596,7 +596,7 @@ ChunkPtgField PlainTerrainGeneratorLameBiomes1::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorLameBiomes2::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
 	/* TODO: Make a real function out of this. */
 	auto octaved_noise = [&](BlockCoords coords, int channel)
@@ -621,8 +621,8 @@ ChunkPtgField PlainTerrainGeneratorLameBiomes2::generate_chunk_ptg_field(
 		return value;
 	};
 
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		glm::vec3 d;
 		for (int i = 0; i < 3; i++)
@@ -682,7 +682,7 @@ ChunkPtgField PlainTerrainGeneratorLameBiomes2::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorLameBiomes3::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
 	/* TODO: Make a real function out of this. */
 	auto octaved_noise = [&](BlockCoords coords, int channel)
@@ -707,8 +707,8 @@ ChunkPtgField PlainTerrainGeneratorLameBiomes3::generate_chunk_ptg_field(
 		return value;
 	};
 
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		glm::vec3 d;
 		for (int i = 0; i < 3; i++)
@@ -771,7 +771,7 @@ ChunkPtgField PlainTerrainGeneratorLameBiomes3::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorLameBiomes4::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
 	/* TODO: Make a real function out of this. */
 	auto octaved_noise = [&](BlockCoords coords, int channel)
@@ -796,8 +796,8 @@ ChunkPtgField PlainTerrainGeneratorLameBiomes4::generate_chunk_ptg_field(
 		return value;
 	};
 
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		glm::vec3 d;
 		for (int i = 0; i < 3; i++)
@@ -862,7 +862,7 @@ ChunkPtgField PlainTerrainGeneratorLameBiomes4::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorLameBiomes5::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
 	/* TODO: Make a real function out of this. */
 	auto octaved_noise = [&](BlockCoords coords, int channel)
@@ -887,8 +887,8 @@ ChunkPtgField PlainTerrainGeneratorLameBiomes5::generate_chunk_ptg_field(
 		return value;
 	};
 
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		glm::vec3 d;
 		for (int i = 0; i < 3; i++)
@@ -954,7 +954,7 @@ ChunkPtgField PlainTerrainGeneratorLameBiomes5::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorLameBiomes6::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
 	/* TODO: Make a real function out of this. */
 	auto octaved_noise = [&](BlockCoords coords, int channel)
@@ -979,8 +979,8 @@ ChunkPtgField PlainTerrainGeneratorLameBiomes6::generate_chunk_ptg_field(
 		return value;
 	};
 
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		glm::vec3 d;
 		for (int i = 0; i < 3; i++)
@@ -1048,7 +1048,7 @@ ChunkPtgField PlainTerrainGeneratorLameBiomes6::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorLameBiomes7::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
 	/* TODO: Make a real function out of this. */
 	auto octaved_noise = [&](BlockCoords coords, int channel)
@@ -1073,8 +1073,8 @@ ChunkPtgField PlainTerrainGeneratorLameBiomes7::generate_chunk_ptg_field(
 		return value;
 	};
 
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		glm::vec3 d;
 		for (int i = 0; i < 3; i++)
@@ -1158,7 +1158,7 @@ ChunkPtgField PlainTerrainGeneratorLameBiomes7::generate_chunk_ptg_field(
 }
 
 ChunkPtgField PlainTerrainGeneratorLameBiomes8::generate_chunk_ptg_field(
-	ChunkCoords chunk_coords, Nature const& nature)
+	ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature)
 {
 	/* TODO: Make a real function out of this. */
 	auto octaved_noise = [&](BlockCoords coords, int channel)
@@ -1204,8 +1204,8 @@ ChunkPtgField PlainTerrainGeneratorLameBiomes8::generate_chunk_ptg_field(
 		}
 	};
 
-	ChunkPtgField ptg_field{chunk_coords};
-	for (BlockCoords coords : chunk_block_rect(chunk_coords))
+	ChunkPtgField ptg_field{chunk_coords, chunk_geometry};
+	for (BlockCoords coords : chunk_geometry.block_rect(chunk_coords))
 	{
 		glm::vec3 d;
 		for (int i = 0; i < 3; i++)
@@ -1302,6 +1302,37 @@ ChunkPtgField PlainTerrainGeneratorLameBiomes8::generate_chunk_ptg_field(
 	return ptg_field;
 }
 
+std::vector<std::string_view> const g_plain_terrain_generator_names{
+	"flat",
+	"classic",
+	"hills",
+	"homogenous",
+	"plane",
+	"planes",
+	"vertical_pillar",
+	"vertical_hole",
+	"horizontal_pillar",
+	"horizontal_hole",
+	"funky_1",
+	"funky_2",
+	"octaves_1",
+	"octaves_2",
+	"noise_test_1",
+	"noise_test_2",
+	"noise_test_3",
+	"noise_test_4",
+	"caves_1",
+	"bimodal_hills",
+	"lame_biomes_1",
+	"lame_biomes_2",
+	"lame_biomes_3",
+	"lame_biomes_4",
+	"lame_biomes_5",
+	"lame_biomes_6",
+	"lame_biomes_7",
+	"lame_biomes_8",
+};
+
 PlainTerrainGenerator* plain_terrain_generator_from_name(std::string_view name)
 {
 	using namespace std::literals::string_view_literals;
@@ -4,6 +4,8 @@
 
 #include "coords.hpp"
 #include "chunk.hpp"
+#include <vector>
+#include <string_view>
 
 namespace qwy2
 {
@@ -12,7 +14,7 @@ class PlainTerrainGenerator
 {
 public:
 	virtual ChunkPtgField generate_chunk_ptg_field(
-		ChunkCoords chunk_coords, Nature const& nature) = 0;
+		ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, Nature const& nature) = 0;
 };
 
 #define SIMPLE_PLAIN_TERRAIN_GENERATOR_SUBCLASS(class_name_) \
@@ -20,7 +22,8 @@ public:
 	{ \
 	public: \
 		virtual ChunkPtgField generate_chunk_ptg_field( \
-			ChunkCoords chunk_coords, Nature const& nature) override; \
+			ChunkCoords chunk_coords, ChunkGeometry chunk_geometry, \
+			Nature const& nature) override; \
 	}
 
 SIMPLE_PLAIN_TERRAIN_GENERATOR_SUBCLASS(PlainTerrainGeneratorFlat);
@@ -54,6 +57,10 @@ SIMPLE_PLAIN_TERRAIN_GENERATOR_SUBCLASS(PlainTerrainGeneratorLameBiomes8);
 
 PlainTerrainGenerator* plain_terrain_generator_from_name(std::string_view name);
 
+/* The names of all the built-in plain terrain generators,
+ * i.e. all the names accepted by `plain_terrain_generator_from_name`. */
+extern std::vector<std::string_view> const g_plain_terrain_generator_names;
+
 } /* qwy2 */
 
 #endif /* QWY2_HEADER_TERRAIN_GEN_ */
@@ -1,59 +1,63 @@
 
 #include "threadpool.hpp"
+#include <algorithm>
 #include <cassert>
 
-#include <iostream>
-
 namespace qwy2
 {
 
-namespace
+TaskPriority::TaskPriority():
+	level{0}, distance{0.0f}
 {
+	;
+}
 
-bool s_threads_should_finish = false;
+TaskPriority::TaskPriority(unsigned int level, float distance):
+	level{level}, distance{distance}
+{
+	;
+}
 
-void thread_endless_work(ThreadPool& thread_pool)
+bool TaskPriority::is_after(TaskPriority const& other) const
 {
-	while(true)
+	if (this->level != other.level)
 	{
-		std::packaged_task<void()> task;
-		{
-			std::unique_lock<std::mutex> lock{thread_pool.task_queue_mutex};
-			if (thread_pool.task_queue.empty())
-			{
-				thread_pool.condition_variable.wait(lock,
-					[&]{return not thread_pool.task_queue.empty();});
-			}
-			task = std::move(thread_pool.task_queue.front());
-			thread_pool.task_queue.pop_front();
-		}
-		if (s_threads_should_finish)
-		{
-			return;
-		}
-		task();
-		{
-			std::unique_lock<std::mutex> lock{thread_pool.free_thread_count_mutex};
-			thread_pool.free_thread_count++;
-		}
+		return this->level < other.level;
 	}
+	return this->distance > other.distance;
+}
+
+bool TaskBatch::is_empty() const
+{
+	return this->task_table.empty();
+}
+
+namespace
+{
+
+/* Comparison for the task heaps, that have their top-priority task on top. */
+bool task_is_after(PrioritizedTask const& left, PrioritizedTask const& right)
+{
+	return left.priority.is_after(right.priority);
 }
 
 } /* Anonymous namespace. */
 
-ThreadPool::ThreadPool()
+ThreadPool::ThreadPool():
+	next_queue_index{0},
+	pending_task_count{0},
+	threads_should_finish{false}
 {
 	;
 }
 
 ThreadPool::~ThreadPool()
 {
-	s_threads_should_finish = true;
-	/* Distribute dummy tasks to all the threads for them to check for s_threads_should_finish. */
-	for (unsigned int i = 0; i < this->thread_table.size(); i++)
 	{
-		this->give_task([](){});
+		std::unique_lock<std::mutex> lock{this->sleep_mutex};
+		this->threads_should_finish = true;
 	}
+	this->sleep_condition_variable.notify_all();
 	for (std::thread& thread : this->thread_table)
 	{
 		thread.join();
@@ -65,9 +69,88 @@ void ThreadPool::set_thread_number(unsigned int thread_number)
 	assert(this->thread_table.empty());
 	for (unsigned int i = 0; i < thread_number; i++)
 	{
-		this->thread_table.emplace_back(thread_endless_work, std::ref(*this));
+		this->queue_table.push_back(std::make_unique<WorkerQueue>());
+	}
+	for (unsigned int i = 0; i < thread_number; i++)
+	{
+		this->thread_table.emplace_back(&ThreadPool::thread_endless_work, this, i);
+	}
+}
+
+void ThreadPool::give_batch(TaskBatch& batch)
+{
+	assert(not this->queue_table.empty());
+	unsigned int const queue_count = this->queue_table.size();
+	int const task_count = batch.task_table.size();
+	if (task_count == 0)
+	{
+		return;
+	}
+
+	/* Each queue gets every `queue_count`-th task of the batch, and is locked only once. */
+	unsigned int const first_queue_index = this->next_queue_index.fetch_add(task_count);
+	for (unsigned int i = 0; i < queue_count && static_cast<int>(i) < task_count; i++)
+	{
+		WorkerQueue& queue = *this->queue_table[(first_queue_index + i) % queue_count];
+		std::unique_lock<std::mutex> lock{queue.mutex};
+		for (unsigned int j = i; static_cast<int>(j) < task_count; j += queue_count)
+		{
+			queue.task_heap.push_back(std::move(batch.task_table[j]));
+			std::push_heap(queue.task_heap.begin(), queue.task_heap.end(), task_is_after);
+		}
+	}
+	batch.task_table.clear();
+
+	{
+		std::unique_lock<std::mutex> lock{this->sleep_mutex};
+		this->pending_task_count += task_count;
+	}
+	if (task_count == 1)
+	{
+		this->sleep_condition_variable.notify_one();
+	}
+	else
+	{
+		this->sleep_condition_variable.notify_all();
+	}
+}
+
+bool ThreadPool::take_task(unsigned int thread_index, PrioritizedTask& task)
+{
+	unsigned int const queue_count = this->queue_table.size();
+	for (unsigned int i = 0; i < queue_count; i++)
+	{
+		WorkerQueue& queue = *this->queue_table[(thread_index + i) % queue_count];
+		std::unique_lock<std::mutex> lock{queue.mutex};
+		if (not queue.task_heap.empty())
+		{
+			std::pop_heap(queue.task_heap.begin(), queue.task_heap.end(), task_is_after);
+			task = std::move(queue.task_heap.back());
+			queue.task_heap.pop_back();
+			this->pending_task_count--;
+			return true;
+		}
+	}
+	return false;
+}
+
+void ThreadPool::thread_endless_work(unsigned int thread_index)
+{
+	while (not this->threads_should_finish)
+	{
+		PrioritizedTask task;
+		if (this->take_task(thread_index, task))
+		{
+			task.task();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock{this->sleep_mutex};
+		this->sleep_condition_variable.wait(lock,
+			[this]{
+				return this->threads_should_finish || this->pending_task_count > 0;
+			});
 	}
-	this->free_thread_count = thread_number;
 }
 
 } /* qwy2 */
@@ -4,30 +4,88 @@
 
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <future>
 #include <functional>
+#include <memory>
 #include <vector>
-#include <deque>
 
-/* Source:
- * https://riptutorial.com/cplusplus/example/15806/create-a-simple-thread-pool */
+namespace qwy2
+{
 
-/* TODO:
- * Rename and comment everything in there to make sure
- * that I will still understand it in the future. */
+/* Tells which tasks are to be taken first by the threads of a `ThreadPool`. */
+class TaskPriority
+{
+public:
+	/* Tasks of higher level are taken first. */
+	unsigned int level;
 
-namespace qwy2
+	/* Among tasks of the same level, the ones with the lowest distance are taken first
+	 * (it is typically the distance between the player and the concerned chunk). */
+	float distance;
+
+public:
+	TaskPriority();
+	TaskPriority(unsigned int level, float distance);
+
+	/* Should a task of this priority be taken after a task of the given priority? */
+	bool is_after(TaskPriority const& other) const;
+};
+
+/* A task in a queue of a `ThreadPool`. */
+class PrioritizedTask
 {
+public:
+	std::packaged_task<void()> task;
+	TaskPriority priority;
+};
 
-class ThreadPool
+/* Tasks that are to be given to a `ThreadPool` all at once, so that giving a lot of tasks
+ * (which happens in the chunk generation manager) only locks each queue of the pool once. */
+class TaskBatch
 {
+private:
+	std::vector<PrioritizedTask> task_table;
+
 public:
+	template<typename FunctionType, typename ReturnType = std::invoke_result_t<FunctionType>>
+	std::future<ReturnType> add_task(FunctionType&& function,
+		TaskPriority priority = TaskPriority{});
+
+	bool is_empty() const;
+
+	friend class ThreadPool;
+};
+
+/* Threads that take tasks and execute them.
+ * Each thread has its own queue of tasks (a heap ordered by priority), and takes its tasks
+ * from its own queue in priority order. When its queue is empty, a thread steals the
+ * top-priority task from the queue of an other thread. The given tasks are distributed
+ * among the queues in a round-robin fashion, so that a thread rarely has to wait on a mutex
+ * and so that the priority order is approximately respected by the pool as a whole. */
+class ThreadPool
+{
+private:
+	class WorkerQueue
+	{
+	public:
+		std::mutex mutex;
+		std::vector<PrioritizedTask> task_heap;
+	};
+
+private:
 	std::vector<std::thread> thread_table;
-	std::condition_variable condition_variable;
-	std::deque<std::packaged_task<void()>> task_queue;
-	std::mutex task_queue_mutex;
-	int free_thread_count;
-	std::mutex free_thread_count_mutex;
+	std::vector<std::unique_ptr<WorkerQueue>> queue_table;
+
+	/* The index of the queue that gets the next given task. */
+	std::atomic<unsigned int> next_queue_index;
+
+	/* The number of tasks in all the queues, threads sleep while there are none. */
+	std::atomic<int> pending_task_count;
+	std::mutex sleep_mutex;
+	std::condition_variable sleep_condition_variable;
+	std::atomic<bool> threads_should_finish;
 
 public:
 	ThreadPool();
@@ -35,23 +93,37 @@ public:
 	void set_thread_number(unsigned int thread_number);
 
 	template<typename FunctionType, typename ReturnType = std::invoke_result_t<FunctionType>>
-	std::future<ReturnType> give_task(FunctionType&& function);
+	std::future<ReturnType> give_task(FunctionType&& function,
+		TaskPriority priority = TaskPriority{});
+
+	/* Gives all the tasks of the given batch, which is left empty. */
+	void give_batch(TaskBatch& batch);
+
+private:
+	/* Takes the top-priority task of the queue of the given thread or else steals one from
+	 * an other queue, returns false if no task was found. */
+	bool take_task(unsigned int thread_index, PrioritizedTask& task);
+
+	void thread_endless_work(unsigned int thread_index);
 };
 
 template<typename FunctionType, typename ReturnType>
-std::future<ReturnType> ThreadPool::give_task(FunctionType&& function)
+std::future<ReturnType> TaskBatch::add_task(FunctionType&& function, TaskPriority priority)
 {
 	std::packaged_task<ReturnType()> task{std::forward<FunctionType>(function)};
 	std::future<ReturnType> future = task.get_future();
-	{
-		std::unique_lock<std::mutex> lock{this->task_queue_mutex};
-		this->task_queue.emplace_back(std::move(task));
-	}
-	this->condition_variable.notify_one();
-	{
-		std::unique_lock<std::mutex> lock{this->free_thread_count_mutex};
-		this->free_thread_count--;
-	}
+	this->task_table.push_back(PrioritizedTask{std::packaged_task<void()>{std::move(task)},
+		priority});
+	return future;
+}
+
+template<typename FunctionType, typename ReturnType>
+std::future<ReturnType> ThreadPool::give_task(FunctionType&& function, TaskPriority priority)
+{
+	TaskBatch batch;
+	std::future<ReturnType> future =
+		batch.add_task(std::forward<FunctionType>(function), priority);
+	this->give_batch(batch);
 	return future;
 }
 